@@ -1,2403 +1,4726 @@
-#include <iostream>
-#include <iomanip>
-#include <string>
-#include <vector>
-#include <memory>
-#include <map>
-#include <algorithm>
-#include <utility>
-#include <cstdlib>
-
-// CONVERT 2D ARRAY CO-ORDINATES TO APPROPRIATE ALGEBRAIC NOTATION
-std::string convertToAlgebraicNotationPos(int y, int x) {
-    // Calculate the rank and file characters and concatenate them into a string
-    return std::string(1, 'a' + x) + std::to_string(8 - y);
-}
-
-// DATA STRUCTURE TO STORE LEGAL MOVES FOR EACH PIECE
-using LegalMovesMap = std::map<std::string, std::vector<std::string>>;
-
-// A MAP OF THE SQUARES THAT WHITE OCCUPIES
-int whitePieceOccupation[8][8];
-// A MAP OF THE SQUARES THAT BLACK OCCUPIES
-int blackPieceOccupation[8][8];
-
-// A MAP OF THE SQUARES THAT WHITE OCCUPIES VIRTUALLY
-int virtual_whitePieceOccupation[8][8];
-// A MAP OF THE SQUARES THAT BLACK OCCUPIES VIRTUALLY
-int virtual_blackPieceOccupation[8][8];
-
-// A MAP OF THE SQUARES THAT WHITE OCCUPIES VIRTUALLY
-int hyper_virtual_whitePieceOccupation[8][8];
-// A MAP OF THE SQUARES THAT BLACK OCCUPIES VIRTUALLY
-int hyper_virtual_blackPieceOccupation[8][8];
-
-int ambiguityMap[8][8];
-
-// MANAGING CASTLING RIGHTS
-bool whiteCastlingRightsKingside = true;
-bool whiteCastlingRightsQueenside = true;
-bool whiteCanCastleKingside = false;
-bool whiteCanCastleQueenside = false;
-
-bool blackCastlingRightsKingside = true;
-bool blackCastlingRightsQueenside = true;
-bool blackCanCastleKingside = false;
-bool blackCanCastleQueenside = false;
-
-// STORES LIST OF MOVES
-std::vector<std::string> movesLog;
-
-std::vector<std::string> whiteRookMoves;
-std::vector<std::string> blackRookMoves;
-
-bool isInputValid(const std::string& userInput, const LegalMovesMap& legalMovesMap) {
-    for (const auto& entry : legalMovesMap) {
-        const std::vector<std::string>& legalMoves = entry.second;
-        for (const std::string& move : legalMoves) {
-            if (userInput == move) {
-                return true; // User input matches a legal move
-            }
-        }
-    }
-    return false; // User input doesn't match any legal move
-}
-
-class Piece {
-public:
-    Piece(std::string color, int y, int x) : color(color), y(y), x(x) {}
-
-    // DESTRUCTOR
-    virtual ~Piece() {}
-    
-    // Functions to retrieve type, color, and position
-    virtual std::string getType() const {
-        return "Piece"; // Override this in derived classes
-    }
-
-    std::string getColor() const {
-        return color;
-    }
-
-    int getRowIndex() const {
-        return y;
-    }
-
-    int getColIndex() const {
-        return x;
-    }
-
-    std::string getPosition() const {
-        return convertToAlgebraicNotationPos(y, x);
-    }
-
-    void setRow(int newY) {
-        y = newY;
-    }
-
-    void setCol(int newX) {
-        x = newX;
-    }
-
-protected:
-    std::string color;
-    int x, y;
-};
-
-class Pawn : public Piece {
-public:
-    Pawn(std::string color, int y, int x) : Piece(color, y, x) {}
-    // Implement Pawn-specific move logic here
-
-    // Modify the generatePawnLegalMoves function to use LegalMovesMap
-    void generatePawnLegalMoves(LegalMovesMap& legalMovesMap, const std::string chessboard[8][8], bool whiteTurn) {
-        // Define legalMoves within the function
-        std::vector<std::string> legalMoves;
-
-        if (whiteTurn) {
-            // FORWARD PAWN MOVES
-            if (isEmptySquare(y - 1, x, chessboard)) {
-                // Add the move one square forward
-                legalMoves.push_back(convertToAlgebraicNotationPos(y - 1, x));
-
-                // PAWN CAN MOVE TWICE FORWARD IF IT HASN'T MOVED YET
-                if (y == 6 && color == "White") {
-                    if (isEmptySquare(y - 2, x, chessboard)) {
-                        // Add the move two squares forward
-                        legalMoves.push_back(convertToAlgebraicNotationPos(y - 2, x));
-                    }
-                }
-            }
-            // CHECK DIAGONAL CAPTURES FOR WHITE PAWNS
-            if (x > 0 && chessboard[y - 1][x - 1] != "-" && chessboard[y - 1][x - 1][0] == 'B') {
-                // Add the diagonal capture move
-                legalMoves.push_back(std::string(1, 'a' + x) + "x" + convertToAlgebraicNotationPos(y - 1, x - 1));
-            }
-
-            if (x < 7 && chessboard[y - 1][x + 1] != "-" && chessboard[y - 1][x + 1][0] == 'B') {
-                // Add the diagonal capture move
-                legalMoves.push_back(std::string(1, 'a' + x) + "x" + convertToAlgebraicNotationPos(y - 1, x + 1));
-            }
-        } else {
-            if (isEmptySquare(y + 1, x, chessboard)) {
-                // Add the move one square forward
-                legalMoves.push_back(convertToAlgebraicNotationPos(y + 1, x));
-
-                // If the pawn is on its starting rank (2 for white, 7 for black), it can move two squares forward
-                if (y == 1 && color == "Black") {
-                    if (isEmptySquare(y + 2, x, chessboard)) {
-                        // Add the move two squares forward
-                        legalMoves.push_back(convertToAlgebraicNotationPos(y + 2, x));
-                    }
-                }
-            }
-            // CHECK DIAGONAL CAPTURES FOR BLACK PAWNS
-            if (x > 0 && chessboard[y + 1][x - 1] != "-" && chessboard[y + 1][x - 1][0] == 'W') {
-                // Add the diagonal capture move
-                legalMoves.push_back(std::string(1, 'a' + x) + "x" + convertToAlgebraicNotationPos(y + 1, x - 1));
-            }
-
-            if (x < 7 && chessboard[y + 1][x + 1] != "-" && chessboard[y + 1][x + 1][0] == 'W') {
-                // Add the diagonal capture move
-                legalMoves.push_back(std::string(1, 'a' + x) + "x" + convertToAlgebraicNotationPos(y + 1, x + 1));
-            }
-        }
-
-        // Store legal moves in the corresponding map
-        legalMovesMap[getPosition()] = legalMoves;
-    }
-
-    // Override getType() to return "Pawn"  
-    std::string getType() const override {
-        return "Pawn";
-    }
-private:
-    bool isEmptySquare(int y, int x, const std::string chessboard[8][8]) {
-        return chessboard[y][x] == "-";
-    }
-};
-
-class Knight : public Piece {
-public:
-    Knight(std::string color, int y, int x) : Piece(color, y, x) {}
-    // Implement Pawn-specific move logic here
-
-    void generateKnightLegalMoves(LegalMovesMap& legalMovesMap, const std::string chessboard[8][8], bool whiteTurn) {
-        // Define legalMoves within the function
-        std::vector<std::string> legalMoves;
-
-        // Knight move offsets
-        int offsetX[8] = {1, 2, 2, 1, -1, -2, -2, -1};
-        int offsetY[8] = {-2, -1, 1, 2, 2, 1, -1, -2};
-
-        // Get the current position of the knight
-        int currentY = getRowIndex();
-        int currentX = getColIndex();
-
-        // Check each possible knight move
-        for (int i = 0; i < 8; i++) {
-            int newY = currentY + offsetY[i];
-            int newX = currentX + offsetX[i];
-
-            // Check if the move is within the board boundaries
-            if (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
-                // Check if the target square is empty or contains an opponent's piece
-                if (chessboard[newY][newX] == "-") {
-                    legalMoves.push_back("N" + convertToAlgebraicNotationPos(newY, newX)); // Knight move
-                } else {
-                    if (whiteTurn) {
-                        if (chessboard[newY][newX][0] == 'B') {
-                            legalMoves.push_back("Nx" + convertToAlgebraicNotationPos(newY, newX)); // Knight move
-                        }
-                    } else {
-                        if (chessboard[newY][newX][0] == 'W') {
-                            legalMoves.push_back("Nx" + convertToAlgebraicNotationPos(newY, newX)); // Knight move
-                        }
-                    }
-                }
-            }
-        }
-        // Store legal moves in the corresponding map
-        legalMovesMap[getPosition()] = legalMoves;
-    }
-
-    // Override getType() to return "Knight"
-    std::string getType() const override {
-        return "Knight";
-    }
-};
-
-class Bishop : public Piece {
-public:
-    Bishop(std::string color, int y, int x) : Piece(color, y, x) {}
-    // Implement Pawn-specific move logic here
-
-    void generateBishopLegalMoves(LegalMovesMap& legalMovesMap, const std::string chessboard[8][8], bool whiteTurn) {
-        // Define legalMoves within the function
-        std::vector<std::string> legalMoves;
-
-        // Offset arrays for diagonal moves
-        int offsetX[4] = {1, 1, -1, -1};
-        int offsetY[4] = {-1, 1, 1, -1};
-
-        // Iterate through all diagonal directions
-        for (int i = 0; i < 4; i++) {
-            int newY = getRowIndex();
-            int newX = getColIndex();
-
-            while (true) {
-                newY += offsetY[i];
-                newX += offsetX[i];
-
-                // Check if the new position is out of bounds
-                if (newY < 0 || newY >= 8 || newX < 0 || newX >= 8) {
-                    break; // Out of bounds, stop in this direction
-                }
-
-                // If the square is empty, it's a legal move
-                if (chessboard[newY][newX] == "-") {
-                    legalMoves.push_back("B" + convertToAlgebraicNotationPos(newY, newX));
-                }
-                
-                // If the square is occupied by an opponent's piece, it's a capture move
-                else if (chessboard[newY][newX][0] != getColor()[0]) {
-                    legalMoves.push_back("Bx" + convertToAlgebraicNotationPos(newY, newX));
-                    break; // Capture move, stop in this direction after capturing
-                }
-
-                // If the square is occupied by any piece (including your own), stop in this direction
-                else {
-                    break;
-                }
-            }
-        }
-
-        // Store legal moves in the corresponding map
-        legalMovesMap[getPosition()] = legalMoves;
-    }
-
-    // Override getType() to return "Bishop"
-    std::string getType() const override {
-        return "Bishop";
-    }
-};
-
-class Rook : public Piece {
-public:
-    Rook(std::string color, int y, int x) : Piece(color, y, x) {}
-    // Implement Pawn-specific move logic here
-
-    void generateRookLegalMoves(LegalMovesMap& legalMovesMap, const std::string chessboard[8][8], bool whiteTurn) {
-        // Define legalMoves within the function
-        std::vector<std::string> legalMoves;
-
-        // Offset arrays for diagonal moves
-        int offsetX[4] = {0, 1, 0, -1};
-        int offsetY[4] = {-1, 0, 1, 0};
-
-        // Iterate through all diagonal directions
-        for (int i = 0; i < 4; i++) {
-            int newY = getRowIndex();
-            int newX = getColIndex();
-
-            while (true) {
-                newY += offsetY[i];
-                newX += offsetX[i];
-
-                // Check if the new position is out of bounds
-                if (newY < 0 || newY >= 8 || newX < 0 || newX >= 8) {
-                    break; // Out of bounds, stop in this direction
-                }
-
-                // If the square is empty, it's a legal move
-                if (chessboard[newY][newX] == "-") {
-                    legalMoves.push_back("R" + convertToAlgebraicNotationPos(newY, newX));
-                }
-                
-                // If the square is occupied by an opponent's piece, it's a capture move
-                else if (chessboard[newY][newX][0] != getColor()[0]) {
-                    legalMoves.push_back("Rx" + convertToAlgebraicNotationPos(newY, newX));
-                    break; // Capture move, stop in this direction after capturing
-                }
-
-                // If the square is occupied by any piece (including your own), stop in this direction
-                else {
-                    break;
-                }
-            }
-        }
-
-        // Store legal moves in the corresponding map
-        legalMovesMap[getPosition()] = legalMoves;
-    }
-
-    // Override getType() to return "Rook"
-    std::string getType() const override {
-        return "Rook";
-    }
-};
-
-class Queen : public Piece {
-public:
-    Queen(std::string color, int y, int x) : Piece(color, y, x) {}
-    // Implement Pawn-specific move logic here
-
-    void generateQueenLegalMoves(LegalMovesMap& legalMovesMap, const std::string chessboard[8][8], bool whiteTurn) {
-        // Define legalMoves within the function
-        std::vector<std::string> legalMoves;
-
-        // Offset arrays for diagonal moves
-        int offsetX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
-        int offsetY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
-
-        // Iterate through all diagonal directions
-        for (int i = 0; i < 8; i++) {
-            int newY = getRowIndex();
-            int newX = getColIndex();
-
-            while (true) {
-                newY += offsetY[i];
-                newX += offsetX[i];
-
-                // Check if the new position is out of bounds
-                if (newY < 0 || newY >= 8 || newX < 0 || newX >= 8) {
-                    break; // Out of bounds, stop in this direction
-                }
-
-                // If the square is empty, it's a legal move
-                if (chessboard[newY][newX] == "-") {
-                    legalMoves.push_back("Q" + convertToAlgebraicNotationPos(newY, newX));
-                }
-                
-                // If the square is occupied by an opponent's piece, it's a capture move
-                else if (chessboard[newY][newX][0] != getColor()[0]) {
-                    legalMoves.push_back("Qx" + convertToAlgebraicNotationPos(newY, newX));
-                    break; // Capture move, stop in this direction after capturing
-                }
-
-                // If the square is occupied by any piece (including your own), stop in this direction
-                else {
-                    break;
-                }
-            }
-        }
-
-        // Store legal moves in the corresponding map
-        legalMovesMap[getPosition()] = legalMoves;
-    }
-
-    // Override getType() to return "Queen"
-    std::string getType() const override {
-        return "Queen";
-    }
-};
-
-class King : public Piece {
-public:
-    King(std::string color, int y, int x) : Piece(color, y, x) {}
-    // Implement Pawn-specific move logic here
-
-    void generateKingLegalMoves(LegalMovesMap& legalMovesMap, const std::string chessboard[8][8], bool whiteTurn) {
-        // Define legalMoves within the function
-        std::vector<std::string> legalMoves;
-
-        int offsetX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
-        int offsetY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
-
-        int currentY = getRowIndex();
-        int currentX = getColIndex();
-
-        for (int i = 0; i < 8; i++) {
-            int newY = currentY + offsetY[i];
-            int newX = currentX + offsetX[i];
-
-            if (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
-                // Check if the square is empty ("-") and not occupied by an opponent's piece
-                if (chessboard[newY][newX] == "-" && ((whiteTurn && blackPieceOccupation[newY][newX] == 0) || (!whiteTurn && whitePieceOccupation[newY][newX] == 0))) {
-                    // Add this move to the list of legal moves as a non-capture move
-                    legalMoves.push_back("K" + convertToAlgebraicNotationPos(newY, newX));
-                }
-                // Check if the square is occupied by an opponent's piece
-                else if (chessboard[newY][newX] != "-" && ((whiteTurn && chessboard[newY][newX][0] == 'B') || (!whiteTurn && chessboard[newY][newX][0] == 'W'))) {
-                    // Add this move to the list of legal moves as a capture move
-                    legalMoves.push_back("Kx" + convertToAlgebraicNotationPos(newY, newX));
-                }
-            }
-        }
-
-        // Store legal moves in the corresponding map
-        legalMovesMap[getPosition()] = legalMoves;
-    }
-
-    // Override getType() to return "King"
-    std::string getType() const override {
-        return "King";
-    }
-};
-
-class Chessboard {
-public:
-    // SETTING UP THE CHESSBOARD
-    void initializeBoard() {
-        // INITIALIZING 8x8 ARRAY WITH PIECES
-        for (int i = 0; i < 8; i++) { // I DENOTES THE ROWS
-            for (int j = 0; j < 8; j++) { // J DENOTES THE COLUMNS
-                // BLACK PIECES: i = 0 and i = 1, WHITE PIECES: i = 6 and i = 7
-                if (i == 0) {
-                    if (j == 0 || j == 7) {
-                        chessboard[i][j] = "BR";
-                        blackPieces.push_back(std::make_shared<Rook>("Black", i, j));
-                    } else if (j == 1 || j == 6) {
-                        chessboard[i][j] = "BN";
-                        blackPieces.push_back(std::make_shared<Knight>("Black", i, j));
-                    } else if (j == 2 || j == 5) {
-                        chessboard[i][j] = "BB";
-                        blackPieces.push_back(std::make_shared<Bishop>("Black", i, j));
-                    } else if (j == 3) {
-                        chessboard[i][j] = "BQ";
-                        blackPieces.push_back(std::make_shared<Queen>("Black", i, j));
-                    } else if (j == 4) {
-                        chessboard[i][j] = "BK";
-                        blackPieces.push_back(std::make_shared<King>("Black", i, j));
-                    }
-                } else if (i == 1) {
-                    chessboard[i][j] = "BP";
-                    blackPieces.push_back(std::make_shared<Pawn>("Black", i, j));
-                } else if (i == 6) {
-                    chessboard[i][j] = "WP";
-                    whitePieces.push_back(std::make_shared<Pawn>("White", i, j));
-                } else if (i == 7) {
-                    // ROOK
-                    if (j == 0 || j == 7) {
-                        chessboard[i][j] = "WR";
-                        whitePieces.push_back(std::make_shared<Rook>("White", i, j));
-                    } else if (j == 1 || j == 6) {
-                        chessboard[i][j] = "WN";
-                        whitePieces.push_back(std::make_shared<Knight>("White", i, j));
-                    } else if (j == 2 || j == 5) {
-                        chessboard[i][j] = "WB";
-                        whitePieces.push_back(std::make_shared<Bishop>("White", i, j));
-                    } else if (j == 3) {
-                        chessboard[i][j] = "WQ";
-                        whitePieces.push_back(std::make_shared<Queen>("White", i, j));
-                    } else if (j == 4) {
-                        chessboard[i][j] = "WK";
-                        whitePieces.push_back(std::make_shared<King>("White", i, j));
-                    }
-                } else {
-                    chessboard[i][j] = "-";
-                }
-            }
-        }
-    }
-
-    void virtual_initializeBoard() {
-
-        virtual_blackPieces.clear();
-        virtual_whitePieces.clear();
-
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 8; j++) {
-                std::string pieceID = virtual_chessboard[i][j];
-                if (pieceID == "WP") {
-                    virtual_whitePieces.push_back(std::make_shared<Pawn>("White", i, j));
-                } else if (pieceID == "WN") {
-                    virtual_whitePieces.push_back(std::make_shared<Knight>("White", i, j));
-                } else if (pieceID == "WB") {
-                    virtual_whitePieces.push_back(std::make_shared<Bishop>("White", i, j));
-                } else if (pieceID == "WR") {
-                    virtual_whitePieces.push_back(std::make_shared<Rook>("White", i, j));
-                } else if (pieceID == "WQ") {
-                    virtual_whitePieces.push_back(std::make_shared<Queen>("White", i, j));
-                } else if (pieceID == "WK") {
-                    virtual_whitePieces.push_back(std::make_shared<King>("White", i, j));
-                } else if (pieceID == "BP") {
-                    virtual_blackPieces.push_back(std::make_shared<Pawn>("Black", i, j));
-                } else if (pieceID == "BN") {
-                    virtual_blackPieces.push_back(std::make_shared<Knight>("Black", i, j));
-                } else if (pieceID == "BB") {
-                    virtual_blackPieces.push_back(std::make_shared<Bishop>("Black", i, j));
-                } else if (pieceID == "BR") {
-                    virtual_blackPieces.push_back(std::make_shared<Rook>("Black", i, j));
-                } else if (pieceID == "BQ") {
-                    virtual_blackPieces.push_back(std::make_shared<Queen>("Black", i, j));
-                } else if (pieceID == "BK") {
-                    virtual_blackPieces.push_back(std::make_shared<King>("Black", i, j));
-                }
-            }
-        }
-    }
-
-    // DISPLAY CHESSBOARD
-    void displayBoard() {
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 8; j++) {
-                // FORMATS OUTPUT IN A TABULAR MANNER
-                std::cout << std::setw(3) << chessboard[i][j];
-            }
-            std::cout << std::endl;
-        }
-    }
-
-    // METHOD TO PRINT POSITIONS OF CHESS PIECES
-    void printPiecePositions() {
-        // OF WHITE COLOUR:
-        std::cout << "White's Chess Piece Positions:" << std::endl;
-        for (const auto& piece : whitePieces) {
-            std::cout << piece->getType() << "(" << piece->getRowIndex() << ", " << piece->getColIndex() << "), ";
-        }
-        std::cout << std::endl;
-        std::cout << std::endl;
-        // OF BLACK COLOUR:
-        std::cout << "Black's Chess Piece Positions:" << std::endl;
-        for (const auto& piece : blackPieces) {
-            std::cout << piece->getType() << "(" << piece->getRowIndex() << ", " << piece->getColIndex() << "), ";
-        }
-        std::cout << std::endl;
-        std::cout << std::endl;
-    }
-
-    void printLegalMoves(bool whiteTurn) {
-        const LegalMovesMap& legalMovesMap = whiteTurn ? whiteLegalMovesMap : blackLegalMovesMap;
-
-        if (whiteTurn) {
-            std::cout << "Legal moves for White:" << std::endl;
-        } else {
-            std::cout << "Legal moves for Black:" << std::endl;
-        }
-
-        for (const auto& entry : legalMovesMap) {
-            const std::string& position = entry.first;
-            const std::vector<std::string>& legalMoves = entry.second;
-
-            std::cout << position << ": ";
-            for (const auto& move : legalMoves) {
-                std::cout << move << " ";
-            }
-            std::cout << ", ";
-        }
-        std::cout << std::endl;
-    }
-
-    void virtual_printLegalMoves(bool whiteTurn) {
-        const LegalMovesMap& legalMovesMap = whiteTurn ? virtual_whiteLegalMovesMap : virtual_blackLegalMovesMap;
-
-        if (whiteTurn) {
-            std::cout << "Legal moves for White:" << std::endl;
-        } else {
-            std::cout << "Legal moves for Black:" << std::endl;
-        }
-
-        for (const auto& entry : legalMovesMap) {
-            const std::string& position = entry.first;
-            const std::vector<std::string>& legalMoves = entry.second;
-
-            std::cout << position << ": ";
-            for (const auto& move : legalMoves) {
-                std::cout << move << " ";
-            }
-            std::cout << ", ";
-        }
-        std::cout << std::endl;
-    }
-
-    // Modify the generateLegalMoves function to handle all piece types
-    void generateLegalMoves(bool whiteTurn) {
-        // Clear the legalMoves maps
-        whiteLegalMovesMap.clear();
-        blackLegalMovesMap.clear();
-
-        // Iterate through the pieces of the current player
-        const std::vector<std::shared_ptr<Piece>>& currentPlayerPieces = whiteTurn ? whitePieces : blackPieces;
-
-        for (const auto& piece : currentPlayerPieces) {
-            if (piece->getType() == "Pawn") {
-                std::shared_ptr<Pawn> pawn = std::dynamic_pointer_cast<Pawn>(piece);
-                if (pawn) {
-                    pawn->generatePawnLegalMoves(whiteTurn ? whiteLegalMovesMap : blackLegalMovesMap, chessboard, whiteTurn);
-                }
-            } else if (piece->getType() == "Knight") {
-                std::shared_ptr<Knight> knight = std::dynamic_pointer_cast<Knight>(piece);
-                if (knight) {
-                    knight->generateKnightLegalMoves(whiteTurn ? whiteLegalMovesMap : blackLegalMovesMap, chessboard, whiteTurn);
-                }
-            } else if (piece->getType() == "Bishop") {
-                std::shared_ptr<Bishop> bishop = std::dynamic_pointer_cast<Bishop>(piece);
-                if (bishop) {
-                    bishop->generateBishopLegalMoves(whiteTurn ? whiteLegalMovesMap : blackLegalMovesMap, chessboard, whiteTurn);
-                }
-            } else if (piece->getType() == "Rook") {
-                std::shared_ptr<Rook> rook = std::dynamic_pointer_cast<Rook>(piece);
-                if (rook) {
-                    rook->generateRookLegalMoves(whiteTurn ? whiteLegalMovesMap : blackLegalMovesMap, chessboard, whiteTurn);
-                }
-            } else if (piece->getType() == "Queen") {
-                std::shared_ptr<Queen> queen = std::dynamic_pointer_cast<Queen>(piece);
-                if (queen) {
-                    queen->generateQueenLegalMoves(whiteTurn ? whiteLegalMovesMap : blackLegalMovesMap, chessboard, whiteTurn);
-                }
-            } else if (piece->getType() == "King") {
-                std::shared_ptr<King> king = std::dynamic_pointer_cast<King>(piece);
-                if (king) {
-                    king->generateKingLegalMoves(whiteTurn ? whiteLegalMovesMap : blackLegalMovesMap, chessboard, whiteTurn);
-                }
-            }
-        }
-
-        // Remove keys with no associated legal moves
-        auto& legalMovesMap = whiteTurn ? whiteLegalMovesMap : blackLegalMovesMap;
-        auto it = legalMovesMap.begin();
-        while (it != legalMovesMap.end()) {
-            if (it->second.empty()) {
-                it = legalMovesMap.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
-
-    void virtual_generateLegalMoves(bool whiteTurn) {
-        // Clear the legalMoves maps
-        virtual_whiteLegalMovesMap.clear();
-        virtual_blackLegalMovesMap.clear();
-
-        // Iterate through the pieces of the current player
-        const std::vector<std::shared_ptr<Piece>>& currentPlayerPieces = whiteTurn ? virtual_whitePieces : virtual_blackPieces;
-
-        for (const auto& piece : currentPlayerPieces) {
-            if (piece->getType() == "Pawn") {
-                std::shared_ptr<Pawn> pawn = std::dynamic_pointer_cast<Pawn>(piece);
-                if (pawn) {
-                    pawn->generatePawnLegalMoves(whiteTurn ? virtual_whiteLegalMovesMap : virtual_blackLegalMovesMap, virtual_chessboard, whiteTurn);
-                }
-            } else if (piece->getType() == "Knight") {
-                std::shared_ptr<Knight> knight = std::dynamic_pointer_cast<Knight>(piece);
-                if (knight) {
-                    knight->generateKnightLegalMoves(whiteTurn ? virtual_whiteLegalMovesMap : virtual_blackLegalMovesMap, virtual_chessboard, whiteTurn);
-                }
-            } else if (piece->getType() == "Bishop") {
-                std::shared_ptr<Bishop> bishop = std::dynamic_pointer_cast<Bishop>(piece);
-                if (bishop) {
-                    bishop->generateBishopLegalMoves(whiteTurn ? virtual_whiteLegalMovesMap : virtual_blackLegalMovesMap, virtual_chessboard, whiteTurn);
-                }
-            } else if (piece->getType() == "Rook") {
-                std::shared_ptr<Rook> rook = std::dynamic_pointer_cast<Rook>(piece);
-                if (rook) {
-                    rook->generateRookLegalMoves(whiteTurn ? virtual_whiteLegalMovesMap : virtual_blackLegalMovesMap, virtual_chessboard, whiteTurn);
-                }
-            } else if (piece->getType() == "Queen") {
-                std::shared_ptr<Queen> queen = std::dynamic_pointer_cast<Queen>(piece);
-                if (queen) {
-                    queen->generateQueenLegalMoves(whiteTurn ? virtual_whiteLegalMovesMap : virtual_blackLegalMovesMap, virtual_chessboard, whiteTurn);
-                }
-            } else if (piece->getType() == "King") {
-                std::shared_ptr<King> king = std::dynamic_pointer_cast<King>(piece);
-                if (king) {
-                    king->generateKingLegalMoves(whiteTurn ? virtual_whiteLegalMovesMap : virtual_blackLegalMovesMap, virtual_chessboard, whiteTurn);
-                }
-            }
-        }
-    }
-
-    // Helper function to print moves
-    void printMoves(const std::vector<std::string>& moves) {
-        for (const auto& move : moves) {
-            std::cout << move << " ";
-        }
-        std::cout << std::endl;
-    }
-
-    void movePieceToPosition(const std::string& fromPosition, const std::string& toPosition) {
-        // Find the piece at the 'fromPosition'
-        std::shared_ptr<Piece> pieceToMove = findPieceAtPosition(fromPosition);
-
-        if (pieceToMove) {
-
-            // Calculate the new position based on the algebraic notation
-            int newY = 8 - (toPosition[1] - '0');
-            int newX = toPosition[0] - 'a';
-
-            // Update the piece's position
-            pieceToMove->setRow(newY);
-            pieceToMove->setCol(newX);
-
-            // Check if there's a piece at the destination position
-            std::shared_ptr<Piece> pieceAtDestination = findPieceAtPosition(toPosition);
-
-            if (pieceAtDestination) {
-                // Remove the captured piece from the game
-                removePieceAtPosition(toPosition);
-            }
-
-            // Remove the piece from its current position
-            removePieceAtPosition(fromPosition);
-
-            // Add the piece to the new position
-            addPieceToPosition(pieceToMove, toPosition);
-
-            // Update the chessboard representation
-            updateChessboard(fromPosition, toPosition);
-        }
-    }
-
-    void resetPieceOccupationMaps() {
-        // Reset both piece occupation maps to all zeros
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 8; j++) {
-                whitePieceOccupation[i][j] = 0;
-                blackPieceOccupation[i][j] = 0;
-            }   
-        }
-    }
-
-    void virtual_resetPieceOccupationMaps() {
-        // Reset both piece occupation maps to all zeros
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 8; j++) {
-                virtual_whitePieceOccupation[i][j] = 0;
-                virtual_blackPieceOccupation[i][j] = 0;
-            }
-        }
-    }
-
-    void resetAmbiguityMap() {
-        // Reset both piece occupation maps to all zeros
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 8; j++) {
-                ambiguityMap[i][j] = 0;
-            }
-        }
-    }
-
-    void hyper_virtual_resetPieceOccupationMaps() {
-        // Reset both piece occupation maps to all zeros
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 8; j++) {
-                hyper_virtual_whitePieceOccupation[i][j] = 0;
-                hyper_virtual_blackPieceOccupation[i][j] = 0;
-            }
-        }
-    }
-
-    void createPieceOccupationMaps() {
-
-        resetPieceOccupationMaps();
-
-        for (int y = 0; y < 8; y++) {
-            for (int x = 0; x < 8; x++) {
-                std::string pieceID = chessboard[y][x];
-                char pieceColour = pieceID[0];
-                char pieceType = pieceID[1];
-
-                if (pieceType == 'P') {
-                    if (pieceColour == 'W') {
-                        if (y - 1 < 8 && x - 1 >= 0) {
-                            whitePieceOccupation[y - 1][x - 1]++;
-                        }
-                        if (y - 1 < 8 && x + 1 < 8) {
-                            whitePieceOccupation[y - 1][x + 1]++;
-                        }
-                    } else {
-                        if (y + 1 < 8 && x - 1 >= 0) {
-                            blackPieceOccupation[y + 1][x - 1]++;
-                        }
-                        if (y + 1 < 8 && x + 1 < 8) {
-                            blackPieceOccupation[y + 1][x + 1]++;
-                        }
-                    }
-                } else if (pieceType == 'N') {
-                    int offsetX[8] = {1, 2, 2, 1, -1, -2, -2, -1};
-                    int offsetY[8] = {-2, -1, 1, 2, 2, 1, -1, -2};
-
-                    for (int i = 0; i < 8; i++) {
-                        int newY = y + offsetY[i];
-                        int newX = x + offsetX[i];
-
-                        if (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
-                            if (pieceColour == 'W') {
-                                whitePieceOccupation[newY][newX]++;
-                            } else {
-                                blackPieceOccupation[newY][newX]++;
-                            }
-                        }
-                    }
-                } else if (pieceType == 'B') {
-                    // Define the possible offsets for bishop moves
-                    int offsetX[4] = {1, 1, -1, -1};
-                    int offsetY[4] = {-1, 1, 1, -1};
-
-                    // Check each possible diagonal move for the bishop
-                    for (int i = 0; i < 4; i++) {
-                        int newY = y + offsetY[i];
-                        int newX = x + offsetX[i];
-
-                        while (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
-                            if (pieceColour == 'W') {
-                                if (chessboard[newY][newX] == "-") {
-                                    whitePieceOccupation[newY][newX]++;
-                                } else {
-                                    whitePieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            } else {
-                                if (chessboard[newY][newX] == "-") {
-                                    blackPieceOccupation[newY][newX]++;
-                                } else {
-                                    blackPieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            }
-
-                            newY += offsetY[i];
-                            newX += offsetX[i];
-                        }
-                    }
-                } else if (pieceType == 'R') {
-                    // Define the possible offsets for bishop moves
-                    int offsetX[4] = {0, 1, 0, -1};
-                    int offsetY[4] = {-1, 0, 1, 0};
-
-                    // Check each possible diagonal move for the bishop
-                    for (int i = 0; i < 4; i++) {
-                        int newY = y + offsetY[i];
-                        int newX = x + offsetX[i];
-
-                        while (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
-                            if (pieceColour == 'W') {
-                                if (chessboard[newY][newX] == "-") {
-                                    whitePieceOccupation[newY][newX]++;
-                                } else {
-                                    whitePieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            } else {
-                                if (chessboard[newY][newX] == "-") {
-                                    blackPieceOccupation[newY][newX]++;
-                                } else {
-                                    blackPieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            }
-
-                            newY += offsetY[i];
-                            newX += offsetX[i];
-                        }
-                    }
-                } else if (pieceType == 'Q') {
-                    // Define the possible offsets for bishop moves
-                    int offsetX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
-                    int offsetY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
-
-                    // Check each possible diagonal move for the bishop
-                    for (int i = 0; i < 8; i++) {
-                        int newY = y + offsetY[i];
-                        int newX = x + offsetX[i];
-
-                        while (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
-                            if (pieceColour == 'W') {
-                                if (chessboard[newY][newX] == "-") {
-                                    whitePieceOccupation[newY][newX]++;
-                                } else {
-                                    whitePieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            } else {
-                                if (chessboard[newY][newX] == "-") {
-                                    blackPieceOccupation[newY][newX]++;
-                                } else {
-                                    blackPieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            }
-
-                            newY += offsetY[i];
-                            newX += offsetX[i];
-                        }
-                    }
-                } else if (pieceType == 'K') {
-                    int offsetX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
-                    int offsetY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
-
-                    for (int i = 0; i < 8; i++) {
-                        int newY = y + offsetY[i];
-                        int newX = x + offsetX[i];
-
-                        if (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
-                            if (pieceColour == 'W') {
-                                whitePieceOccupation[newY][newX]++;
-                            } else {
-                                blackPieceOccupation[newY][newX]++;
-                            }
-
-                            newY += offsetY[i];
-                            newX += offsetX[i];
-                        }
-                    }
-                }
-            }
-        }
-
-        // DISPLAY OCCUPATION MAPS
-        /*
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 8; j++) {
-                // FORMATS OUTPUT IN A TABULAR MANNER
-                std::cout << std::setw(3) << whitePieceOccupation[i][j];
-            }
-            std::cout << std::endl;
-        }
-        std::cout << std::endl;
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 8; j++) {
-                // FORMATS OUTPUT IN A TABULAR MANNER
-                std::cout << std::setw(3) << blackPieceOccupation[i][j];
-            }
-            std::cout << std::endl;
-        }
-        std::cout << std::endl;
-        */
-    }
-
-    void virtual_createPieceOccupationMaps() {
-        for (int y = 0; y < 8; y++) {
-            for (int x = 0; x < 8; x++) {
-                std::string pieceID = virtual_chessboard[y][x];
-                char pieceColour = pieceID[0];
-                char pieceType = pieceID[1];
-
-                if (pieceType == 'P') {
-                    if (pieceColour == 'W') {
-                        if (y - 1 < 8 && x - 1 >= 0) {
-                            virtual_whitePieceOccupation[y - 1][x - 1]++;
-                        }
-                        if (y - 1 < 8 && x + 1 < 8) {
-                            virtual_whitePieceOccupation[y - 1][x + 1]++;
-                        }
-                    } else {
-                        if (y + 1 < 8 && x - 1 >= 0) {
-                            virtual_blackPieceOccupation[y + 1][x - 1]++;
-                        }
-                        if (y + 1 < 8 && x + 1 < 8) {
-                            virtual_blackPieceOccupation[y + 1][x + 1]++;
-                        }
-                    }
-                } else if (pieceType == 'N') {
-                    int offsetX[8] = {1, 2, 2, 1, -1, -2, -2, -1};
-                    int offsetY[8] = {-2, -1, 1, 2, 2, 1, -1, -2};
-
-                    for (int i = 0; i < 8; i++) {
-                        int newY = y + offsetY[i];
-                        int newX = x + offsetX[i];
-
-                        if (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
-                            if (pieceColour == 'W') {
-                                virtual_whitePieceOccupation[newY][newX]++;
-                            } else {
-                                virtual_blackPieceOccupation[newY][newX]++;
-                            }
-                        }
-                    }
-                } else if (pieceType == 'B') {
-                    // Define the possible offsets for bishop moves
-                    int offsetX[4] = {1, 1, -1, -1};
-                    int offsetY[4] = {-1, 1, 1, -1};
-
-                    // Check each possible diagonal move for the bishop
-                    for (int i = 0; i < 4; i++) {
-                        int newY = y + offsetY[i];
-                        int newX = x + offsetX[i];
-
-                        while (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
-                            if (pieceColour == 'W') {
-                                if (virtual_chessboard[newY][newX] == "-") {
-                                    virtual_whitePieceOccupation[newY][newX]++;
-                                } else {
-                                    virtual_whitePieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            } else {
-                                if (virtual_chessboard[newY][newX] == "-") {
-                                    virtual_blackPieceOccupation[newY][newX]++;
-                                } else {
-                                    virtual_blackPieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            }
-
-                            newY += offsetY[i];
-                            newX += offsetX[i];
-                        }
-                    }
-                } else if (pieceType == 'R') {
-                    // Define the possible offsets for bishop moves
-                    int offsetX[4] = {0, 1, 0, -1};
-                    int offsetY[4] = {-1, 0, 1, 0};
-
-                    // Check each possible diagonal move for the bishop
-                    for (int i = 0; i < 4; i++) {
-                        int newY = y + offsetY[i];
-                        int newX = x + offsetX[i];
-
-                        while (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
-                            if (pieceColour == 'W') {
-                                if (virtual_chessboard[newY][newX] == "-") {
-                                    virtual_whitePieceOccupation[newY][newX]++;
-                                } else {
-                                    virtual_whitePieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            } else {
-                                if (virtual_chessboard[newY][newX] == "-") {
-                                    virtual_blackPieceOccupation[newY][newX]++;
-                                } else {
-                                    virtual_blackPieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            }
-
-                            newY += offsetY[i];
-                            newX += offsetX[i];
-                        }
-                    }
-                } else if (pieceType == 'Q') {
-                    // Define the possible offsets for bishop moves
-                    int offsetX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
-                    int offsetY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
-
-                    // Check each possible diagonal move for the bishop
-                    for (int i = 0; i < 8; i++) {
-                        int newY = y + offsetY[i];
-                        int newX = x + offsetX[i];
-
-                        while (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
-                            if (pieceColour == 'W') {
-                                if (virtual_chessboard[newY][newX] == "-") {
-                                    virtual_whitePieceOccupation[newY][newX]++;
-                                } else {
-                                    virtual_whitePieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            } else {
-                                if (virtual_chessboard[newY][newX] == "-") {
-                                    virtual_blackPieceOccupation[newY][newX]++;
-                                } else {
-                                    virtual_blackPieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            }
-
-                            newY += offsetY[i];
-                            newX += offsetX[i];
-                        }
-                    }
-                } else if (pieceType == 'K') {
-                    int offsetX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
-                    int offsetY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
-
-                    for (int i = 0; i < 8; i++) {
-                        int newY = y + offsetY[i];
-                        int newX = x + offsetX[i];
-
-                        if (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
-                            if (pieceColour == 'W') {
-                                virtual_whitePieceOccupation[newY][newX]++;
-                            } else {
-                                virtual_blackPieceOccupation[newY][newX]++;
-                            }
-
-                            newY += offsetY[i];
-                            newX += offsetX[i];
-                        }
-                    }
-                }
-            }
-        }
-
-        // DISPLAY OCCUPATION MAPS
-        /*
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 8; j++) {
-                // FORMATS OUTPUT IN A TABULAR MANNER
-                std::cout << std::setw(3) << virtual_whitePieceOccupation[i][j];
-            }
-            std::cout << std::endl;
-        }
-        std::cout << std::endl;
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 8; j++) {
-                // FORMATS OUTPUT IN A TABULAR MANNER
-                std::cout << std::setw(3) << virtual_blackPieceOccupation[i][j];
-            }
-            std::cout << std::endl;
-        }
-        std::cout << std::endl;
-        */
-    }
-
-    void hyper_virtual_createPieceOccupationMaps() {
-        for (int y = 0; y < 8; y++) {
-            for (int x = 0; x < 8; x++) {
-                std::string pieceID = hyper_virtual_chessboard[y][x]; // PREFIX HYPER_
-                char pieceColour = pieceID[0];
-                char pieceType = pieceID[1];
-
-                if (pieceType == 'P') {
-                    if (pieceColour == 'W') {
-                        if (y - 1 < 8 && x - 1 >= 0) {
-                            hyper_virtual_whitePieceOccupation[y - 1][x - 1]++;
-                        }
-                        if (y - 1 < 8 && x + 1 < 8) {
-                            hyper_virtual_whitePieceOccupation[y - 1][x + 1]++;
-                        }
-                    } else {
-                        if (y + 1 < 8 && x - 1 >= 0) {
-                            hyper_virtual_blackPieceOccupation[y + 1][x - 1]++;
-                        }
-                        if (y + 1 < 8 && x + 1 < 8) {
-                            hyper_virtual_blackPieceOccupation[y + 1][x + 1]++;
-                        }
-                    }
-                } else if (pieceType == 'N') {
-                    int offsetX[8] = {1, 2, 2, 1, -1, -2, -2, -1};
-                    int offsetY[8] = {-2, -1, 1, 2, 2, 1, -1, -2};
-
-                    for (int i = 0; i < 8; i++) {
-                        int newY = y + offsetY[i];
-                        int newX = x + offsetX[i];
-
-                        if (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
-                            if (pieceColour == 'W') {
-                                hyper_virtual_whitePieceOccupation[newY][newX]++;
-                            } else {
-                                hyper_virtual_blackPieceOccupation[newY][newX]++;
-                            }
-                        }
-                    }
-                } else if (pieceType == 'B') {
-                    // Define the possible offsets for bishop moves
-                    int offsetX[4] = {1, 1, -1, -1};
-                    int offsetY[4] = {-1, 1, 1, -1};
-
-                    // Check each possible diagonal move for the bishop
-                    for (int i = 0; i < 4; i++) {
-                        int newY = y + offsetY[i];
-                        int newX = x + offsetX[i];
-
-                        while (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
-                            if (pieceColour == 'W') {
-                                if (hyper_virtual_chessboard[newY][newX] == "-") {
-                                    hyper_virtual_whitePieceOccupation[newY][newX]++;
-                                } else {
-                                    hyper_virtual_whitePieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            } else {
-                                if (hyper_virtual_chessboard[newY][newX] == "-") {
-                                    hyper_virtual_blackPieceOccupation[newY][newX]++;
-                                } else {
-                                    hyper_virtual_blackPieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            }
-
-                            newY += offsetY[i];
-                            newX += offsetX[i];
-                        }
-                    }
-                } else if (pieceType == 'R') {
-                    // Define the possible offsets for bishop moves
-                    int offsetX[4] = {0, 1, 0, -1};
-                    int offsetY[4] = {-1, 0, 1, 0};
-
-                    // Check each possible diagonal move for the bishop
-                    for (int i = 0; i < 4; i++) {
-                        int newY = y + offsetY[i];
-                        int newX = x + offsetX[i];
-
-                        while (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
-                            if (pieceColour == 'W') {
-                                if (hyper_virtual_chessboard[newY][newX] == "-") {
-                                    hyper_virtual_whitePieceOccupation[newY][newX]++;
-                                } else {
-                                    hyper_virtual_whitePieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            } else {
-                                if (hyper_virtual_chessboard[newY][newX] == "-") {
-                                    hyper_virtual_blackPieceOccupation[newY][newX]++;
-                                } else {
-                                    hyper_virtual_blackPieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            }
-
-                            newY += offsetY[i];
-                            newX += offsetX[i];
-                        }
-                    }
-                } else if (pieceType == 'Q') {
-                    // Define the possible offsets for bishop moves
-                    int offsetX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
-                    int offsetY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
-
-                    // Check each possible diagonal move for the bishop
-                    for (int i = 0; i < 8; i++) {
-                        int newY = y + offsetY[i];
-                        int newX = x + offsetX[i];
-
-                        while (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
-                            if (pieceColour == 'W') {
-                                if (hyper_virtual_chessboard[newY][newX] == "-") {
-                                    hyper_virtual_whitePieceOccupation[newY][newX]++;
-                                } else {
-                                    hyper_virtual_whitePieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            } else {
-                                if (hyper_virtual_chessboard[newY][newX] == "-") {
-                                    hyper_virtual_blackPieceOccupation[newY][newX]++;
-                                } else {
-                                    hyper_virtual_blackPieceOccupation[newY][newX]++;
-                                    break;
-                                }
-                            }
-
-                            newY += offsetY[i];
-                            newX += offsetX[i];
-                        }
-                    }
-                } else if (pieceType == 'K') {
-                    int offsetX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
-                    int offsetY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
-
-                    for (int i = 0; i < 8; i++) {
-                        int newY = y + offsetY[i];
-                        int newX = x + offsetX[i];
-
-                        if (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
-                            if (pieceColour == 'W') {
-                                hyper_virtual_whitePieceOccupation[newY][newX]++;
-                            } else {
-                                hyper_virtual_blackPieceOccupation[newY][newX]++;
-                            }
-
-                            newY += offsetY[i];
-                            newX += offsetX[i];
-                        }
-                    }
-                }
-            }
-        }
-
-        // DISPLAY OCCUPATION MAPS
-        /*
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 8; j++) {
-                // FORMATS OUTPUT IN A TABULAR MANNER
-                std::cout << std::setw(3) << hyper_virtual_whitePieceOccupation[i][j];
-            }
-            std::cout << std::endl;
-        }
-        std::cout << std::endl;
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 8; j++) {
-                // FORMATS OUTPUT IN A TABULAR MANNER
-                std::cout << std::setw(3) << hyper_virtual_blackPieceOccupation[i][j];
-            }
-            std::cout << std::endl;
-        }
-        std::cout << std::endl;
-        */
-    }
-
-    void printTryMoves(const std::map<std::string, std::vector<int>>& results) {
-        std::cout << "Results Map:" << std::endl;
-        for (const auto& entry : results) {
-            const std::string& position = entry.first;
-            const std::vector<int>& moveLegality = entry.second;
-            std::cout << position << ": ";
-            for (int legality : moveLegality) {
-                std::cout << legality << " ";
-            }
-            std::cout << ", ";
-        }
-        std::cout << std::endl;
-    }
-
-    std::map<std::string, std::vector<int>> TryMoves(bool whiteTurn, const std::map<std::string, std::vector<std::string>>& legalMovesMap) {
-        std::map<std::string, std::vector<int>> results;
-
-        for (const auto& move : legalMovesMap) {
-            const std::string& key = move.first;
-            const std::vector<std::string>& values = move.second;
-
-            std::vector<int> legality;
-
-            // Loop through values and print each move
-            for (const std::string& value : values) {
-
-                std::string move = value;
-
-                char character;
-                
-                if (value.length() >= 4 && value[value.length() - 2] == '=' && std::isalpha(value[value.length() - 1])) {
-                    character = value.back();
-                    std::cout << character << std::endl;
-                    move.erase(move.end() - 2, move.end());
-                }
-                
-                std::string moveTo = move.substr(move.length() - 2);
-
-                // std::cout << "Trying move: " << key << " to " << moveTo << std::endl;
-
-                virtual_resetPieceOccupationMaps();
-                
-                for (int y = 0; y < 8; y++) {
-                    for (int x = 0; x < 8; x++) {
-                        virtual_chessboard[y][x] = chessboard[y][x];
-                    }
-                }
-
-                // Extract the source and destination positions from the move
-                std::string moveFrom = key;
-
-                int fromY = 8 - (moveFrom[1] - '0');
-                int fromX = moveFrom[0] - 'a';
-                int toY = 8 - (moveTo[1] - '0');
-                int toX = moveTo[0] - 'a';
-
-                std::string temp = virtual_chessboard[fromY][fromX];
-                virtual_chessboard[fromY][fromX] = "-";
-                virtual_chessboard[toY][toX] = temp;
-
-                // FIX BUGS
-
-                if (value.length() >= 4 && value[value.length() - 2] == '=' && std::isalpha(value[value.length() - 1])) {
-                    virtual_chessboard[toY][toX] = std::string(1, temp[0]) + std::string(1, character);
-                }
-
-                /*
-                for (int y = 0; y < 8; y++) {
-                    for (int x = 0; x < 8; x++) {
-                        std::cout << std::setw(3) << virtual_chessboard[y][x];
-                    }
-                    std::cout << std::endl;
-                }
-                std::cout << std::endl;
-                */
-
-                // CALL DUPLICATE PIECEOCCUPATIONMAP FUNCTION
-                virtual_createPieceOccupationMaps();
-
-                int whiteKingY, whiteKingX, blackKingY, blackKingX;
-
-                for (int y = 0; y < 8; y++) {
-                    for (int x = 0; x < 8; x++) {
-                        if (virtual_chessboard[y][x] == "WK") {
-                            whiteKingY = y;
-                            whiteKingX = x;
-                        } else if (virtual_chessboard[y][x] == "BK") {
-                            blackKingY = y;
-                            blackKingX = x;
-                        }
-                    }
-                }
-
-                std::map<std::string, std::vector<std::string>> map = TwoMoveScan(!whiteTurn, !whiteTurn ? virtual_whiteLegalMovesMap : virtual_blackLegalMovesMap);
-
-                if (whiteTurn) {
-                    if (virtual_blackPieceOccupation[whiteKingY][whiteKingX] != 0) {
-                        legality.push_back(1);
-                    } else {
-                        if (virtual_whitePieceOccupation[blackKingY][blackKingX] != 0) {
-                            if (map.empty()) {
-                                legality.push_back(3);
-                            } else {
-                                legality.push_back(2);
-                            }
-                        } else {
-                            legality.push_back(0);
-                        }
-                    }
-                } else {
-                    if (virtual_whitePieceOccupation[blackKingY][blackKingX] != 0) {
-                        legality.push_back(1);
-                    } else {
-                        if (virtual_blackPieceOccupation[whiteKingY][whiteKingX] != 0) {
-                            if (map.empty()) {
-                                legality.push_back(3);
-                            } else {
-                                legality.push_back(2);
-                            }
-                        } else {
-                            legality.push_back(0);
-                        }
-                    }
-                }
-            }
-
-            results[key] = legality;
-        }
-
-        // printTryMoves(results);
-        // Scans for checks
-        scanForChecks(whiteTurn, whiteTurn ? whiteLegalMovesMap : blackLegalMovesMap, results);
-        // Scans for checks
-        scanForCheckmates(whiteTurn, whiteTurn ? whiteLegalMovesMap : blackLegalMovesMap, results);
-        // Filter out illegal moves from legalMovesMap
-        filterIllegalMoves(whiteTurn, whiteTurn ? whiteLegalMovesMap : blackLegalMovesMap, results);
-
-        return results;
-    }
-    
-    std::map<std::string, std::vector<std::string>> TwoMoveScan(bool whiteTurn, const std::map<std::string, std::vector<std::string>>& virtual_legalMovesMap) {
-        virtual_initializeBoard();
-        virtual_generateLegalMoves(whiteTurn);
-        // virtual_printLegalMoves(whiteTurn);
-
-        std::map<std::string, std::vector<std::string>> results;
-
-        for (const auto& move : virtual_legalMovesMap) {
-            const std::string& key = move.first;
-            const std::vector<std::string>& values = move.second;
-
-            // Loop through values and print each move
-            for (const std::string& value : values) {
-
-                std::string move = value;
-
-                char character;
-                
-                if (value.length() >= 4 && value[value.length() - 2] == '=' && std::isalpha(value[value.length() - 1])) {
-                    character = value.back();
-                    std::cout << character << std::endl;
-                    move.erase(move.end() - 2, move.end());
-                }
-                
-                std::string moveTo = move.substr(move.length() - 2);
-
-                hyper_virtual_resetPieceOccupationMaps();
-
-                // GENERATING LEGAL MOVES FOR EACH PLAYER IN EACH VIRTUAL_CHESSBOARD POSITION
-                for (int y = 0; y < 8; y++) {
-                    for (int x = 0; x < 8; x++) {
-                        hyper_virtual_chessboard[y][x] = virtual_chessboard[y][x];
-                    }
-                }
-
-                // Extract the source and destination positions from the move
-                std::string moveFrom = key;
-
-                int fromY = 8 - (moveFrom[1] - '0');
-                int fromX = moveFrom[0] - 'a';
-                int toY = 8 - (moveTo[1] - '0');
-                int toX = moveTo[0] - 'a';
-
-                std::string temp = hyper_virtual_chessboard[fromY][fromX];
-                hyper_virtual_chessboard[fromY][fromX] = "-";
-                hyper_virtual_chessboard[toY][toX] = temp;
-
-                if (value.length() >= 4 && value[value.length() - 2] == '=' && std::isalpha(value[value.length() - 1])) {
-                    hyper_virtual_chessboard[toY][toX] = std::string(1, temp[0]) + std::string(1, character);
-                }
-
-                /*
-                for (int y = 0; y < 8; y++) {
-                    for (int x = 0; x < 8; x++) {
-                        std::cout << std::setw(3) << hyper_virtual_chessboard[y][x];
-                    }
-                    std::cout << std::endl;
-                }
-                */
-
-                // CALL DUPLICATE PIECEOCCUPATIONMAP FUNCTION
-                hyper_virtual_createPieceOccupationMaps();
-
-                int whiteKingY, whiteKingX, blackKingY, blackKingX;
-
-                for (int y = 0; y < 8; y++) {
-                    for (int x = 0; x < 8; x++) {
-                        if (hyper_virtual_chessboard[y][x] == "WK") {
-                            whiteKingY = y;
-                            whiteKingX = x;
-                        } else if (hyper_virtual_chessboard[y][x] == "BK") {
-                            blackKingY = y;
-                            blackKingX = x;
-                        }
-                    }
-                }
-
-                if (whiteTurn) {
-                    if (hyper_virtual_blackPieceOccupation[whiteKingY][whiteKingX] == 0) {
-                        // If the condition is met, add the key-value pair to the results map
-                        results[key] = values;
-                    }
-                } else {
-                    if (hyper_virtual_whitePieceOccupation[blackKingY][blackKingX] == 0) {
-                        // If the condition is met, add the key-value pair to the results map
-                        results[key] = values;
-                    }
-                }
-            }
-        }
-
-        return results;
-    }
-
-    void filterIllegalMoves(bool whiteTurn, std::map<std::string, std::vector<std::string>>& legalMovesMap, std::map<std::string, std::vector<int>>& results) {
-        for (auto it = legalMovesMap.begin(); it != legalMovesMap.end();) {
-            const std::string& key = it->first;
-            std::vector<std::string>& legalMoves = it->second;
-
-            const std::vector<int>& moveResults = results[key];
-
-            // Iterate in reverse to remove from highest index to lowest
-            for (int i = legalMoves.size() - 1; i >= 0; --i) {
-                if (moveResults[i] == 1) {
-                    legalMoves.erase(legalMoves.begin() + i);
-                }
-            }
-
-            // Remove keys with no associated legal moves
-            if (legalMoves.empty()) {
-                it = legalMovesMap.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
-
-    void scanForChecks(bool whiteTurn, std::map<std::string, std::vector<std::string>>& legalMovesMap, const std::map<std::string, std::vector<int>>& results) {
-        for (auto& entry : legalMovesMap) {
-            const std::string& key = entry.first;
-            std::vector<std::string>& legalMoves = entry.second;
-
-            const std::vector<int>& moveResults = results.at(key);
-
-            for (int i = 0; i < legalMoves.size(); ++i) {
-                if (moveResults[i] == 2) {
-                    // Add a "+" to the move to indicate a check
-                    legalMoves[i] += "+";
-                }
-            }
-        }
-    }
-
-    void scanForCheckmates(bool whiteTurn, std::map<std::string, std::vector<std::string>>& legalMovesMap, const std::map<std::string, std::vector<int>>& results) {
-        for (auto& entry : legalMovesMap) {
-            const std::string& key = entry.first;
-            std::vector<std::string>& legalMoves = entry.second;
-
-            const std::vector<int>& moveResults = results.at(key);
-
-            for (int i = 0; i < legalMoves.size(); ++i) {
-                if (moveResults[i] == 3) {
-                    // Add a "+" to the move to indicate a check
-                    legalMoves[i] += "#";
-                }
-            }
-        }
-    }
-
-    void scanAmbiguity(bool whiteTurn, const std::map<std::string, std::vector<std::string>>& legalMovesMap) {
-
-        char scanForColour = whiteTurn ? 'W' : 'B';
-        char scanForPieceType[4] = {'N', 'B', 'R', 'Q'};
-
-        for (int i = 0; i < 4; i++) {
-            resetAmbiguityMap();
-            matchingPieceKeys = {};
-
-            std::string targetID = std::string(1, scanForColour) + scanForPieceType[i];
-            // Iterate through all squares on the chessboard
-            for (int y = 0; y < 8; y++) {
-                for (int x = 0; x < 8; x++) {
-                    // Check if the piece on the current square matches the target ID
-                    if (chessboard[y][x] == targetID) {
-                        // Convert the piece's location to algebraic notation
-                        std::string pieceLocation = std::string(1, static_cast<char>('a' + x)) + std::to_string(8 - y);
-
-                        // Add the pieceLocation to the vector of matching piece keys
-                        matchingPieceKeys.push_back(pieceLocation);
-
-                        // Iterate through all keys in legalMovesMap
-                        for (const auto& keyValuePair : legalMovesMap) {
-                            const std::string& key = keyValuePair.first;
-                            
-                            // Check if pieceLocation matches the key
-                            if (pieceLocation == key) {
-                                // pieceLocation matches a key in legalMovesMap
-                                // Now you can process this piece's legal moves
-                                const std::vector<std::string>& legalMoves = keyValuePair.second;
-                                
-                                // Iterate through legalMoves and handle ambiguity
-                                for (const std::string& legalMove : legalMoves) {
-                                    // Create a new string variable to store the modified legal move
-                                    std::string cleanLegalMove = legalMove;
-                                    
-                                    // Remove '+' or '#' if they exist
-                                    if (!cleanLegalMove.empty() && (cleanLegalMove.back() == '+' || cleanLegalMove.back() == '#')) {
-                                        cleanLegalMove.pop_back();
-                                    }
-                                    
-                                    // Initialize the string with just the last two characters (coordinates in algebraic notation)
-                                    cleanLegalMove = cleanLegalMove.substr(cleanLegalMove.length() - 2);
-
-                                    // Update ambiguityMap based on the last two characters of cleanLegalMove
-                                    int toY = 8 - (cleanLegalMove[1] - '0');
-                                    int toX = cleanLegalMove[0] - 'a';
-                                    ambiguityMap[toY][toX]++;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-
-            // DEBUGGING
-            /*
-            for (int i = 0; i < 8; i++) {
-                for (int j = 0; j < 8; j++) {
-                    std::cout << std::setw(3) << ambiguityMap[i][j];
-                }
-                std::cout << std::endl;
-            }
-            std::cout << std::endl;
-            */
-
-            // CHECKING AMBIGUITY
-            for (int i = 0; i < 8; i++) {
-                for (int j = 0; j < 8; j++) {
-                    if (ambiguityMap[i][j] > 1) {
-                        std::string square = std::string(1, static_cast<char>('a' + j)) + std::to_string(8 - i);
-                        // Check if the square has ambiguity
-                        // Find matching piece keys for this square
-                        std::vector<std::string> ambiguousPieces;
-                        for (const auto& keyValuePair : legalMovesMap) {
-                            const std::string& key = keyValuePair.first;
-                            bool keyExistsInMatchingPieces = false;
-
-                            // Check if the key exists in matchingPieceKeys
-                            for (const std::string& matchingKey : matchingPieceKeys) {
-                                if (key == matchingKey) {
-                                    keyExistsInMatchingPieces = true;
-                                    break;
-                                }
-                            }
-
-                            // If the key exists in matchingPieceKeys, check for square coordinates
-                            if (keyExistsInMatchingPieces) {
-                                // Convert the square coordinates to algebraic notation
-                                if (legalMovesMap.find(key) != legalMovesMap.end()) {
-                                    const std::vector<std::string>& legalMoves = legalMovesMap.find(key)->second;
-                                    for (const std::string& legalMove : legalMoves) {
-                                        if (legalMove.find(square) != std::string::npos) {
-                                            ambiguousPieces.push_back(key);
-                                            break; // No need to check further legal moves for this key
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                        /*
-                        // Print the ambiguous pieces
-                        if (!ambiguousPieces.empty()) {
-                            std::cout << "Ambiguous Pieces at Square " << std::string(1, static_cast<char>('a' + j)) << 8 - i << ": ";
-                            for (const std::string& piece : ambiguousPieces) {
-                                std::cout << piece << " ";
-                            }
-                            std::cout << std::endl;
-                        }
-                        */
-
-                        std::string concatenatedPieces;
-                        for (const std::string& piece : ambiguousPieces) {
-                            concatenatedPieces += piece;
-                        }
-
-                        // COUNT OCCURANCES OF EACH CHARACTER IN PIECE
-                        for (const std::string& piece : ambiguousPieces) {
-                            int letterCount = 0;
-                            int numCount = 0;
-                            char searchLetter = piece[0];
-                            char searchNum = piece[1];
-
-                            // SCAN
-                            for (char c : concatenatedPieces) {
-                                if (c == searchLetter) {
-                                    letterCount++;
-                                } else if (c == searchNum) {
-                                    numCount++;
-                                }
-                            }
-
-                            // std::cout << "Letter Count: " << letterCount << std::endl;
-                            // std::cout << "Number Count: " << numCount << std::endl;
-
-                            // Search for the ambiguous piece in legalMovesMap
-                            auto it = legalMovesMap.find(piece);
-                            
-                            if (it != legalMovesMap.end()) {
-                                // Found the ambiguous piece, now let's scan its values
-                                const std::vector<std::string>& values = it->second;
-                                
-                                for (auto itValue = values.begin(); itValue != values.end(); ++itValue) {
-                                    // Check if the value contains the ambiguity square
-                                    size_t pos = itValue->find(square);
-                                    if (pos != std::string::npos) {
-                                        // The substring square exists in value
-                                        std::string value = *itValue;
-
-                                        // Initialize pieceTypeIdentifier as the first character of value
-                                        char pieceTypeIdentifier = value[0];
-
-                                        // Initialize remainder as the rest of value (excluding the first character)
-                                        std::string remainder = value.substr(1);
-
-                                        std::string newValue;
-
-                                        if (letterCount > 1 && numCount > 1) {
-                                            newValue = std::string(1, pieceTypeIdentifier) + piece + remainder;
-                                        } else if (letterCount > 1 && numCount == 1) {
-                                            newValue = std::string(1, pieceTypeIdentifier) + searchNum + remainder;
-                                        } else {
-                                            newValue = std::string(1, pieceTypeIdentifier) + searchLetter + remainder;
-                                        }
-                                        
-                                        std::cout << newValue << std::endl;
-
-                                        modifyLegalMove(whiteTurn ? whiteLegalMovesMap : blackLegalMovesMap, piece, value, newValue);
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    void modifyLegalMove(std::map<std::string, std::vector<std::string>>& legalMovesMap, const std::string& key, std::string& value, const std::string& newValue) {
-        auto it = legalMovesMap.find(key);
-        if (it != legalMovesMap.end()) {
-            std::vector<std::string>& values = it->second;
-            for (std::string& val : values) {
-                if (val == value) {
-                    val = newValue; // Update the value with newValue
-                    break; // No need to continue searching
-                }
-            }
-        }
-    }
-
-    void checkCastlingRights(bool whiteTurn, const std::map<std::string, std::vector<std::string>>& legalMovesMap) {
-        int x = whiteTurn ? 0 : 1;
-        // THE PLAYER MUST NOT HAVE CASTLED ALREADY OR MOVED THEIR KING
-        for (int i = x; i < movesLog.size(); i += 2) {
-
-            whiteCanCastleKingside = false;
-            whiteCanCastleQueenside = false;
-            blackCanCastleKingside = false;
-            blackCanCastleQueenside = false;
-            
-            if (movesLog[i] == "O-O" || movesLog[i] == "O-O-O" || movesLog[i].find('K') != std::string::npos) {
-                if (whiteTurn) {
-                    whiteCastlingRightsKingside = false;
-                    whiteCastlingRightsQueenside = false;
-                    whiteCanCastleKingside = false;
-                    whiteCanCastleQueenside = false;
-                } else {
-                    blackCastlingRightsKingside = false;
-                    blackCastlingRightsQueenside = false;
-                    blackCanCastleKingside = false;
-                    blackCanCastleQueenside = false;
-                }
-                return;
-            }
-        }
-
-        // A PLAYER CANNOT CASTLE WHEN THEY'RE IN CHECK
-        if (movesLog.back().find('+') != std::string::npos) {
-            if (whiteTurn) {
-                whiteCanCastleKingside = false;
-                whiteCanCastleQueenside = false;
-            } else {
-                blackCanCastleKingside = false;
-                blackCanCastleQueenside = false;
-            }
-            return;
-        }
-
-        std::cout << "whiteRookMoves: ";
-        for (const std::string& move : whiteRookMoves) {
-            std::cout << move << " ";
-        }
-        std::cout << std::endl;
-
-        std::cout << "blackRookMoves: ";
-        for (const std::string& move : blackRookMoves) {
-            std::cout << move << " ";
-        }
-        std::cout << std::endl;
-        
-        const std::vector<std::string>& rookMoves = whiteTurn ? whiteRookMoves : blackRookMoves;
-        for (const std::string& move : rookMoves) {
-            if (whiteTurn) {
-                if (move == "a1") {
-                    whiteCanCastleQueenside = false;
-                    whiteCastlingRightsQueenside = false;
-                } 
-                if (move == "h1"){
-                    whiteCanCastleKingside = false;
-                    whiteCastlingRightsKingside = false;
-                }
-            } else {
-                if (move == "a8") {
-                    blackCanCastleQueenside = false;
-                    blackCastlingRightsQueenside = false;
-                } 
-                if (move == "h8"){
-                    blackCanCastleKingside = false;
-                    blackCastlingRightsKingside = false;
-                }
-            }
-        }
-
-        if (whiteCastlingRightsKingside) {
-            if (chessboard[7][5] == "-" && chessboard[7][6] == "-" && blackPieceOccupation[7][5] == 0 && blackPieceOccupation[7][6] == 0) {
-                whiteCanCastleKingside = true;
-            }
-        } 
-        if (whiteCastlingRightsQueenside) {
-            if (chessboard[7][1] == "-" && chessboard[7][2] == "-" && chessboard[7][3] == "-" && blackPieceOccupation[7][2] == 0 && blackPieceOccupation[7][3] == 0) {
-                whiteCanCastleQueenside = true;
-            }
-        }
-        if (blackCastlingRightsKingside) {
-            if (chessboard[0][5] == "-" && chessboard[0][6] == "-" && whitePieceOccupation[0][5] == 0 && whitePieceOccupation[0][6] == 0) {
-                blackCanCastleKingside = true;
-            }
-        }
-        if (blackCastlingRightsQueenside) {
-            if (chessboard[0][1] == "-" && chessboard[0][2] == "-" && chessboard[0][3] == "-" && whitePieceOccupation[0][2] == 0 && whitePieceOccupation[0][3] == 0) {
-                blackCanCastleQueenside = true;
-            }
-        }
-
-        std::string castlingMove;
-
-        if (whiteTurn) {
-            if (whiteCanCastleKingside && whiteCanCastleKingside) {
-                castlingMove = "O-O";
-                addCastlingMove(whiteTurn, castlingMove, whiteTurn ? whiteLegalMovesMap : blackLegalMovesMap);
-            } 
-            if (whiteCanCastleQueenside && whiteCanCastleQueenside) {
-                castlingMove = "O-O-O";
-                addCastlingMove(whiteTurn, castlingMove, whiteTurn ? whiteLegalMovesMap : blackLegalMovesMap);
-            }
-        } else {
-            if (blackCanCastleKingside && blackCanCastleKingside) {
-                castlingMove = "O-O";
-                addCastlingMove(whiteTurn, castlingMove, whiteTurn ? whiteLegalMovesMap : blackLegalMovesMap);
-            } 
-            if (blackCanCastleQueenside && blackCanCastleQueenside) {
-                castlingMove = "O-O-O";
-                addCastlingMove(whiteTurn, castlingMove, whiteTurn ? whiteLegalMovesMap : blackLegalMovesMap);
-            }
-        }
-    }
-
-    void findKeyOfRook(bool whiteTurn, std::string input_copy, const std::map<std::string, std::vector<std::string>>& legalMovesMap) {
-        for (const auto& keyValuePair : legalMovesMap) {
-            const std::string& key = keyValuePair.first;
-            const std::vector<std::string>& values = keyValuePair.second;
-
-            // Check if input_copy is found within the values
-            if (std::find(values.begin(), values.end(), input_copy) != values.end()) {
-                // Push the key to the correct player's rook moves vector
-                if (whiteTurn) {
-                    whiteRookMoves.push_back(key);
-                } else {
-                    blackRookMoves.push_back(key);
-                }
-                break; // Exit the loop after finding the key
-            }
-        }
-    }
-
-    void addCastlingMove(bool whiteTurn, std::string castlingMove, std::map<std::string, std::vector<std::string>>& legalMovesMap) {
-        std::string kingPosition = whiteTurn ? "e1" : "e8"; // Determine the king's position based on the player's turn
-    
-        // Check if the king's position exists in the legalMovesMap
-        auto it = legalMovesMap.find(kingPosition);
-        
-        if (it != legalMovesMap.end()) {
-            // Found the king's position in legalMovesMap
-            // Add the castling move to the list of legal moves for the king's position
-            it->second.push_back(castlingMove);
-        }
-    }
-
-    void performCastling(bool whiteTurn, const std::string& castlingMove) {
-        // Check if it's kingside or queenside castling
-        if (castlingMove == "O-O") {
-            // Kingside castling
-            if (whiteTurn) {
-                // Check if white can kingside castle
-                if (whiteCanCastleKingside) {
-                    // Move the king
-                    movePieceToPosition("e1", "g1");
-                    // Move the rook
-                    movePieceToPosition("h1", "f1");
-                    // Update castling rights
-                    whiteCanCastleKingside = false;
-                    whiteCanCastleQueenside = false;
-                    whiteCastlingRightsKingside = false;
-                    whiteCastlingRightsQueenside = false;
-                }
-            } else {
-                // Check if black can kingside castle
-                if (blackCanCastleKingside) {
-                    // Move the king
-                    movePieceToPosition("e8", "g8");
-                    // Move the rook
-                    movePieceToPosition("h8", "f8");
-                    // Update castling rights
-                    blackCanCastleKingside = false;
-                    blackCanCastleQueenside = false;
-                    blackCastlingRightsKingside = false;
-                    blackCastlingRightsQueenside = false;
-                }
-            }
-        } else if (castlingMove == "O-O-O") {
-            // Queenside castling
-            if (whiteTurn) {
-                // Check if white can queenside castle
-                if (whiteCanCastleQueenside) {
-                    // Move the king
-                    movePieceToPosition("e1", "c1");
-                    // Move the rook
-                    movePieceToPosition("a1", "d1");
-                    // Update castling rights
-                    whiteCanCastleKingside = false;
-                    whiteCanCastleQueenside = false;
-                    whiteCastlingRightsKingside = false;
-                    whiteCastlingRightsQueenside = false;
-                }
-            } else {
-                // Check if black can queenside castle
-                if (blackCanCastleQueenside) {
-                    // Move the king
-                    movePieceToPosition("e8", "c8");
-                    // Move the rook
-                    movePieceToPosition("a8", "d8");
-                    // Update castling rights
-                    blackCanCastleKingside = false;
-                    blackCanCastleQueenside = false;
-                    blackCastlingRightsKingside = false;
-                    blackCastlingRightsQueenside = false;
-                }
-            }
-        }
-    }
-
-    // Function to check for pawn promotion moves and add them
-    void checkPawnPromotions(bool whiteTurn, const std::map<std::string, std::vector<std::string>>& legalMovesMap) {
-        
-        for (auto& keyValuePair : legalMovesMap) {
-            const std::string& key = keyValuePair.first;
-            const std::vector<std::string>& values = keyValuePair.second;
-
-            // Create a vector to store new promotion moves
-            std::vector<std::string> newMoves;
-
-            // Create a vector to store pawn promotion moves for this key
-            std::vector<std::string> pawnPromotionMoves;
-
-            for (const std::string& move : values) {
-                if (whiteTurn) {
-                    // Check if it's a white pawn promotion move
-                    if (move.back() == '8' && std::all_of(move.begin(), move.end() - 1, ::islower)) {
-                        pawnPromotionMoves.push_back(move);
-                    }
-                    else {
-                        // Keep non-promotion moves for white
-                        newMoves.push_back(move);
-                    }
-                }
-                else {
-                    // Check if it's a black pawn promotion move
-                    if (move.back() == '1' && std::all_of(move.begin(), move.end() - 1, ::islower)) {
-                        pawnPromotionMoves.push_back(move);
-                    }
-                    else {
-                        // Keep non-promotion moves for black
-                        newMoves.push_back(move);
-                    }
-                }
-            }
-
-            // Add the original moves without promotion
-            newMoves.insert(newMoves.end(), pawnPromotionMoves.begin(), pawnPromotionMoves.end());
-
-            // Call a function to add 4 new promotion moves for each promotion move
-            for (const std::string& promotionMove : pawnPromotionMoves) {
-                addPawnPromotionMoves(key, promotionMove, whiteTurn ? whiteLegalMovesMap : blackLegalMovesMap);
-            }
-        }
-    }
-
-    // Function to add promotion moves for a pawn promotion move
-    void addPawnPromotionMoves(const std::string& key, const std::string& pawnPromotionMove, std::map<std::string, std::vector<std::string>>& legalMovesMap) {
-        // Find the key that contains pawnPromotionMove
-        auto it = legalMovesMap.find(key);
-
-        if (it != legalMovesMap.end()) {
-            std::vector<std::string>& moves = it->second;
-
-            // Remove the original pawn promotion move
-            moves.erase(std::remove(moves.begin(), moves.end(), pawnPromotionMove), moves.end());
-
-            // Add 4 new promotion moves
-            // Add promotion move with Queen (Q)
-            moves.push_back(pawnPromotionMove + "=Q");
-            // Add promotion move with Rook (R)
-            moves.push_back(pawnPromotionMove + "=R");
-            // Add promotion move with Knight (N)
-            moves.push_back(pawnPromotionMove + "=N");
-            // Add promotion move with Bishop (B)
-            moves.push_back(pawnPromotionMove + "=B");
-        }
-    }
-
-    void performPawnPromotion(bool whiteTurn, std::string input_copy, char promotionPiece) {
-        input_copy = input_copy.substr(input_copy.length() - 2);
-        int y = 8 - (input_copy[1] - '0');
-        int x = input_copy[0] - 'a';
-        char colour = whiteTurn ? 'W' : 'B';
-        std::string pieceID = std::string(1, colour) + std::string(1, promotionPiece);
-        chessboard[y][x] = pieceID;
-
-        // Find the pawn that reached the promotion square based on its position
-        std::shared_ptr<Piece> pawnToPromote = nullptr;
-
-        // Dereference the shared pointers to obtain raw pointers
-        std::vector<std::shared_ptr<Piece>>& pieces = whiteTurn ? whitePieces : blackPieces;
-
-        for (const auto& piece_ptr : pieces) {
-            if (piece_ptr->getRowIndex() == y && piece_ptr->getColIndex() == x && piece_ptr->getType() == "Pawn") {
-                pawnToPromote = piece_ptr;
-                break;
-            }
-        }
-
-        if (pawnToPromote != nullptr) {
-            // Create the new piece
-            std::shared_ptr<Piece> newPiece = nullptr;
-            if (promotionPiece == 'Q') {
-                newPiece = std::make_shared<Queen>(whiteTurn ? "White" : "Black", y, x);
-            } else if (promotionPiece == 'R') {
-                newPiece = std::make_shared<Rook>(whiteTurn ? "White" : "Black", y, x);
-            } else if (promotionPiece == 'B') {
-                newPiece = std::make_shared<Bishop>(whiteTurn ? "White" : "Black", y, x);
-            } else if (promotionPiece == 'N') {
-                newPiece = std::make_shared<Knight>(whiteTurn ? "White" : "Black", y, x);
-            }
-
-            if (newPiece != nullptr) {
-                // Find and erase the old pawn from the vector
-                auto iter = std::find(pieces.begin(), pieces.end(), pawnToPromote);
-                if (iter != pieces.end()) {
-                    pieces.erase(iter);
-                }
-
-                // Optionally, reset the shared_ptr for pawnToPromote (no need to delete it)
-                pawnToPromote.reset();
-
-                // Add the new piece to the appropriate vector
-                pieces.push_back(newPiece);
-            }
-        }
-    }
-
-    const LegalMovesMap& getWhiteLegalMovesMap() const {
-        return whiteLegalMovesMap;
-    }
-
-    const LegalMovesMap& getBlackLegalMovesMap() const {
-        return blackLegalMovesMap;
-    }
-
-    const LegalMovesMap& getVirtualWhiteLegalMovesMap() const {
-        return virtual_whiteLegalMovesMap;
-    }
-
-    const LegalMovesMap& getVirtualBlackLegalMovesMap() const {
-        return virtual_blackLegalMovesMap;
-    }
-
-private:
-
-    // SETS SIZE OF CHESSBOARD (8x8)
-    std::string chessboard[8][8];
-    // STORES ALL OF WHITE'S PIECES AS A VECTOR
-    std::vector<std::shared_ptr<Piece>> whitePieces;
-    // STORES ALL OF BLACK'S PIECES AS A VECTOR
-    std::vector<std::shared_ptr<Piece>> blackPieces;
-
-    // SETS SIZE OF VIRTUAL CHESSBOARD (8x8)
-    std::string virtual_chessboard[8][8];
-    // STORES ALL OF WHITE'S PIECES IN A VIRTUAL POSITION
-    std::vector<std::shared_ptr<Piece>> virtual_whitePieces;
-    // STORES ALL OF BLACK'S PIECES IN A VIRTUAL POSITION
-    std::vector<std::shared_ptr<Piece>> virtual_blackPieces;
-
-    // Create a vector to store the keys of pieces matching the target ID
-    std::vector<std::string> matchingPieceKeys;
-
-    // SETS SIZE OF VIRTUAL CHESSBOARD (8x8)
-    std::string hyper_virtual_chessboard[8][8];
-
-    // Define LegalMovesMap for white and black pieces
-    LegalMovesMap whiteLegalMovesMap;
-    LegalMovesMap blackLegalMovesMap;
-
-    // Define LegalMovesMap for virtua wwhite and black pieces
-    LegalMovesMap virtual_whiteLegalMovesMap;
-    LegalMovesMap virtual_blackLegalMovesMap;
-
-    // Helper function to find a piece at a given position
-    std::shared_ptr<Piece> findPieceAtPosition(const std::string& position) {
-        for (auto& piece : whitePieces) {
-            if (piece->getPosition() == position) {
-                return piece;
-            }
-        }
-        for (auto& piece : blackPieces) {
-            if (piece->getPosition() == position) {
-                return piece;
-            }
-        }
-        return nullptr; // Piece not found
-    }
-
-    // Helper function to remove a piece at a given position
-    void removePieceAtPosition(const std::string& position) {
-        whitePieces.erase(std::remove_if(whitePieces.begin(), whitePieces.end(),
-            [&position](const std::shared_ptr<Piece>& piece) {
-                return piece->getPosition() == position;
-            }), whitePieces.end());
-
-        blackPieces.erase(std::remove_if(blackPieces.begin(), blackPieces.end(),
-            [&position](const std::shared_ptr<Piece>& piece) {
-                return piece->getPosition() == position;
-            }), blackPieces.end());
-    }
-
-    // Helper function to add a piece to a given position
-    void addPieceToPosition(const std::shared_ptr<Piece>& piece, const std::string& position) {
-        if (piece->getColor() == "White") {
-            whitePieces.push_back(piece);
-        } else {
-            blackPieces.push_back(piece);
-        }
-    }
-
-
-    // Helper function to update the chessboard based on the pieces' positions
-    void updateChessboard(const std::string& fromPosition, const std::string& toPosition) {
-        // Calculate the coordinates for the 'from' and 'to' positions
-        int fromY = 8 - (fromPosition[1] - '0');
-        int fromX = fromPosition[0] - 'a';
-        int toY = 8 - (toPosition[1] - '0');
-        int toX = toPosition[0] - 'a';
-
-        // Store the piece in 'temp'
-        std::string temp = chessboard[fromY][fromX];
-
-        // Set the 'from' position to empty ("-")
-        chessboard[fromY][fromX] = "-";
-
-        // Update the 'to' position with the stored piece
-        chessboard[toY][toX] = temp;
-    }
-};
-
-int main() {
-    Chessboard chessboard;
-    chessboard.initializeBoard();
-
-    // WHITE ALWAYS STARTS FIRST
-    bool whiteTurn = true;
-    // CHECKMATE VARIABLE TO DETERMINE WHETHER GAME ENDS
-    bool checkmate = false;
-    // ALTERNATIVELY, DRAW IF MOVE REPETITION OR 50-MOVE RULE
-    bool draw = false;
-    // TEMPORARY TURN LIMIT
-    int i = 0;
-
-    while (!checkmate) {
-        chessboard.displayBoard();
-        chessboard.createPieceOccupationMaps();
-        chessboard.printPiecePositions(); 
-        std::string input;
-
-        bool valid = false;
-        while (valid == false) {
-            chessboard.generateLegalMoves(whiteTurn); // Generate legal moves for the current player
-            if (!movesLog.empty()) {
-                chessboard.checkCastlingRights(whiteTurn, whiteTurn ? chessboard.getWhiteLegalMovesMap() : chessboard.getBlackLegalMovesMap());
-            }
-            chessboard.checkPawnPromotions(whiteTurn, whiteTurn ? chessboard.getWhiteLegalMovesMap() : chessboard.getBlackLegalMovesMap());
-            chessboard.TryMoves(whiteTurn, whiteTurn ? chessboard.getWhiteLegalMovesMap() : chessboard.getBlackLegalMovesMap());
-            chessboard.scanAmbiguity(whiteTurn, whiteTurn ? chessboard.getWhiteLegalMovesMap() : chessboard.getBlackLegalMovesMap());
-            chessboard.printLegalMoves(whiteTurn);   // Print legal moves for the current player
-            
-            // Print the moves map for each player
-            if (whiteTurn) {
-                std::cout << "White's Legal Moves Map:" << std::endl;
-                const LegalMovesMap& whiteMovesMap = chessboard.getWhiteLegalMovesMap();
-                for (const auto& entry : whiteMovesMap) {
-                    const std::string& position = entry.first;
-                    const std::vector<std::string>& legalMoves = entry.second;
-                    std::cout << position << ": ";
-                    for (const auto& move : legalMoves) {
-                        std::cout << move << " ";
-                    }
-                    std::cout << ", ";
-                }
-                std::cout << std::endl;
-            } else {
-                std::cout << "Black's Legal Moves Map:" << std::endl;
-                const LegalMovesMap& blackMovesMap = chessboard.getBlackLegalMovesMap();
-                for (const auto& entry : blackMovesMap) {
-                    const std::string& position = entry.first;
-                    const std::vector<std::string>& legalMoves = entry.second;
-                    std::cout << position << ": ";
-                    for (const auto& move : legalMoves) {
-                        std::cout << move << " ";
-                    }
-                    std::cout << ", ";
-                }
-                std::cout << std::endl;
-            }
-
-            std::cout << std::endl;
-
-            for (size_t moveNumber = 0; moveNumber < movesLog.size(); ++moveNumber) {
-                // Print the move number before white's move
-                if (moveNumber % 2 == 0) {
-                    std::cout << moveNumber / 2 + 1 << ". ";
-                }
-                
-                // Print the player's move
-                std::cout << movesLog[moveNumber];
-
-                // Add a space after every move
-                std::cout << " ";
-            }
-            std::cout << std::endl;
-
-            if (i % 2 == 0) {
-                std::cout << "White to move. " << ((i-(i%2))/2)+1 << ". ";
-            } else {
-                std::cout << "Black to move. " << ((i-(i%2))/2)+1 << ". ";
-            }
-
-            std::cin >> input;
-            std::cout << std::endl;
-
-            if (isInputValid(input, whiteTurn ? chessboard.getWhiteLegalMovesMap() : chessboard.getBlackLegalMovesMap())) {
-                movesLog.push_back(input);
-                std::string input_copy = input;
-                
-                if (input_copy.find('R') != std::string::npos) {
-                    std::cout << "Move starts with R." << std::endl;
-                    chessboard.findKeyOfRook(whiteTurn, input_copy, whiteTurn ? chessboard.getWhiteLegalMovesMap() : chessboard.getBlackLegalMovesMap());
-                }
-
-                // Check if the input move ends with '+' or '#'
-                if (input_copy.back() == '+' || input_copy.back() == '#') {
-                    // Remove the last character if it's '+' or '#'
-                    input_copy.pop_back();
-                    if (input_copy.back() == '#') {
-                        checkmate = true;
-                        // Terminate the program
-                        std::cout << "Checkmate! Game over." << std::endl;
-                        std::abort; // 0 indicates successful program termination
-                    }
-                }
-
-                std::cout << "reached2" << std::endl;
-
-                if (input_copy == "O-O" || input_copy == "O-O-O") {
-                    chessboard.performCastling(whiteTurn, input_copy);
-                } else {
-                    if (input_copy.length() >= 4 && input_copy[input_copy.length() - 2] == '=' && std::isalpha(input_copy[input_copy.length() - 1])) {
-                        // Handle pawn promotion here
-                        // Extract the piece to promote to (the last character)
-                        char promotionPiece = input_copy.back();
-
-                        // Remove the last two characters to get the destination square
-                        std::string new_copy = input_copy;
-                        input_copy.erase(input_copy.end() - 2, input_copy.end());
-
-                        std::cout << input_copy << std::endl;
-
-                        std::cout << "Pawn promotion move." << std::endl; 
-
-                        const LegalMovesMap& movesMap = whiteTurn ? chessboard.getWhiteLegalMovesMap() : chessboard.getBlackLegalMovesMap();
-
-                        // EXTRACT MOVE-TO POSITION OF PIECE FROM INPUT
-                        std::string pieceMoveToPosition = input_copy.substr(input_copy.length() - 2);
-                        // Initialize a variable to store the position of the piece moved
-                        std::string pieceMovedPosition = "";
-
-                        // Use std::find to search for the input move in the vector of legal moves
-                        for (const auto& entry : movesMap) {
-                            if (std::find(entry.second.begin(), entry.second.end(), input) != entry.second.end()) {
-                                // This piece can make the move
-                                pieceMovedPosition = entry.first;
-                                break;
-                            }
-                        }
-
-                        chessboard.movePieceToPosition(pieceMovedPosition, pieceMoveToPosition);
-                        std::cout << "reached1" << std::endl;
-                        chessboard.performPawnPromotion(whiteTurn, input_copy, promotionPiece);
-                    } else {
-                        // It's a regular move
-                        // EXTRACT MOVE-TO POSITION OF PIECE FROM INPUT
-                        std::string pieceMoveToPosition = input_copy.substr(input_copy.length() - 2);
-                        // Initialize a variable to store the position of the piece moved
-                        std::string pieceMovedPosition = "";
-
-                        const LegalMovesMap& movesMap = whiteTurn ? chessboard.getWhiteLegalMovesMap() : chessboard.getBlackLegalMovesMap();
-
-                        // Use std::find to search for the input move in the vector of legal moves
-                        for (const auto& entry : movesMap) {
-                            if (std::find(entry.second.begin(), entry.second.end(), input) != entry.second.end()) {
-                                // This piece can make the move
-                                pieceMovedPosition = entry.first;
-                                break;
-                            }
-                        }
-
-                        chessboard.movePieceToPosition(pieceMovedPosition, pieceMoveToPosition);
-
-                        std::cout << "Piece moved: " << pieceMovedPosition << std::endl;
-                    }
-                }
-
-                valid = true;
-            } else {
-                std::cout << "Invalid move. Try again." << std::endl;
-            }
-        }
-
-        ++i;
-
-        whiteTurn = !whiteTurn;
-    }
-    return 0;
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <map>
+#include <algorithm>
+#include <utility>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <sstream>
+#include <chrono>
+#include <atomic>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <new>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(USE_PEXT) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+// BITBOARD: ONE BIT PER SQUARE, a1 = BIT 0, b1 = BIT 1, ..., h8 = BIT 63
+typedef uint64_t Bitboard;
+
+enum Color { WHITE, BLACK, COLOR_NB };
+
+constexpr Color operator~(Color c) {
+    return Color(c ^ BLACK);
+}
+
+enum PieceType { NO_PIECE_TYPE, PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING, PIECE_TYPE_NB };
+
+// PIECE CODES STORED IN THE MAILBOX: BIT 3 IS THE COLOUR, BITS 0-2 ARE THE PIECE TYPE
+enum PieceCode : uint8_t {
+    NO_PIECE,
+    W_PAWN = 1, W_KNIGHT, W_BISHOP, W_ROOK, W_QUEEN, W_KING,
+    B_PAWN = 9, B_KNIGHT, B_BISHOP, B_ROOK, B_QUEEN, B_KING,
+    PIECE_CODE_NB = 16
+};
+
+enum Square : int {
+    SQ_A1, SQ_B1, SQ_C1, SQ_D1, SQ_E1, SQ_F1, SQ_G1, SQ_H1,
+    SQ_A2, SQ_B2, SQ_C2, SQ_D2, SQ_E2, SQ_F2, SQ_G2, SQ_H2,
+    SQ_A3, SQ_B3, SQ_C3, SQ_D3, SQ_E3, SQ_F3, SQ_G3, SQ_H3,
+    SQ_A4, SQ_B4, SQ_C4, SQ_D4, SQ_E4, SQ_F4, SQ_G4, SQ_H4,
+    SQ_A5, SQ_B5, SQ_C5, SQ_D5, SQ_E5, SQ_F5, SQ_G5, SQ_H5,
+    SQ_A6, SQ_B6, SQ_C6, SQ_D6, SQ_E6, SQ_F6, SQ_G6, SQ_H6,
+    SQ_A7, SQ_B7, SQ_C7, SQ_D7, SQ_E7, SQ_F7, SQ_G7, SQ_H7,
+    SQ_A8, SQ_B8, SQ_C8, SQ_D8, SQ_E8, SQ_F8, SQ_G8, SQ_H8,
+    SQ_NONE, SQUARE_NB = 64
+};
+
+inline PieceCode makePiece(Color c, PieceType pt) {
+    return PieceCode((c << 3) | pt);
+}
+
+inline Color colorOf(PieceCode pc) {
+    return Color(pc >> 3);
+}
+
+inline PieceType typeOf(PieceCode pc) {
+    return PieceType(pc & 7);
+}
+
+// CONVERT 2D ARRAY CO-ORDINATES (ROW 0 = RANK 8) TO A SQUARE INDEX AND BACK
+inline Square makeSquare(int y, int x) {
+    return Square((7 - y) * 8 + x);
+}
+
+inline int rowOf(Square s) {
+    return 7 - (s >> 3);
+}
+
+inline int colOf(Square s) {
+    return s & 7;
+}
+
+inline Bitboard squareBB(Square s) {
+    return 1ULL << s;
+}
+
+constexpr Bitboard FILE_A_BB = 0x0101010101010101ULL;
+constexpr Bitboard FILE_H_BB = FILE_A_BB << 7;
+constexpr Bitboard RANK_1_BB = 0xFFULL;
+constexpr Bitboard RANK_3_BB = RANK_1_BB << 16;
+constexpr Bitboard RANK_6_BB = RANK_1_BB << 40;
+constexpr Bitboard RANK_8_BB = RANK_1_BB << 56;
+
+inline int popcount(Bitboard b) {
+    return __builtin_popcountll(b);
+}
+
+// INDEX OF THE LEAST SIGNIFICANT SET BIT
+inline Square lsb(Bitboard b) {
+    return Square(__builtin_ctzll(b));
+}
+
+// RETURNS THE LEAST SIGNIFICANT SQUARE AND CLEARS IT FROM THE BITBOARD
+inline Square popLsb(Bitboard& b) {
+    Square s = lsb(b);
+    b &= b - 1;
+    return s;
+}
+
+// CONVERT 2D ARRAY CO-ORDINATES TO APPROPRIATE ALGEBRAIC NOTATION
+std::string convertToAlgebraicNotationPos(int y, int x) {
+    // Calculate the rank and file characters and concatenate them into a string
+    return std::string(1, 'a' + x) + std::to_string(8 - y);
+}
+
+std::string squareToString(Square s) {
+    return convertToAlgebraicNotationPos(rowOf(s), colOf(s));
+}
+
+// PIECE TYPE FROM ITS SAN LETTER ('N', 'B', 'R', 'Q', 'K')
+PieceType pieceTypeFromChar(char c) {
+    switch (c) {
+        case 'P': return PAWN;
+        case 'N': return KNIGHT;
+        case 'B': return BISHOP;
+        case 'R': return ROOK;
+        case 'Q': return QUEEN;
+        case 'K': return KING;
+        default: return NO_PIECE_TYPE;
+    }
+}
+
+// MOVE TYPES, STORED IN THE TOP TWO BITS OF A MOVE
+enum MoveType {
+    NORMAL,
+    PROMOTION = 1 << 14,
+    EN_PASSANT = 2 << 14,
+    CASTLING = 3 << 14
+};
+
+// A MOVE PACKED INTO 16 BITS:
+// BITS 0-5 DESTINATION SQUARE, BITS 6-11 ORIGIN SQUARE, BITS 12-13 PROMOTION PIECE (KNIGHT..QUEEN), BITS 14-15 MOVE TYPE
+// CASTLING IS ENCODED AS THE KING'S TWO-SQUARE MOVE
+class Move {
+public:
+    Move() : data(0) {}
+
+    explicit Move(uint16_t raw) : data(raw) {}
+
+    Move(Square from, Square to, MoveType type = NORMAL, PieceType promotion = KNIGHT)
+        : data(uint16_t(type | ((promotion - KNIGHT) << 12) | (from << 6) | to)) {}
+
+    Square from() const {
+        return Square((data >> 6) & 0x3F);
+    }
+
+    Square to() const {
+        return Square(data & 0x3F);
+    }
+
+    MoveType type() const {
+        return MoveType(data & (3 << 14));
+    }
+
+    PieceType promotionType() const {
+        return PieceType(((data >> 12) & 3) + KNIGHT);
+    }
+
+    uint16_t raw() const {
+        return data;
+    }
+
+    bool operator==(Move other) const {
+        return data == other.data;
+    }
+
+    bool operator!=(Move other) const {
+        return data != other.data;
+    }
+
+private:
+    uint16_t data;
+};
+
+const Move MOVE_NONE;
+
+const char* const START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// COORDINATE NOTATION OF A MOVE ("e2e4", "e7e8q"), AS USED BY THE PERFT DIVIDE OUTPUT
+std::string moveToUCI(Move move) {
+    std::string uci = squareToString(move.from()) + squareToString(move.to());
+    if (move.type() == PROMOTION) {
+        uci += " pnbrqk"[move.promotionType()];
+    }
+    return uci;
+}
+
+// BUILD WITH -DCHECK_ALLOC TO COUNT HEAP ALLOCATIONS PER THREAD. AN AllocationGuard ABORTS IF ANY HAPPENED WHILE IT
+// WAS IN SCOPE; THE TABLEBASE PROBE, WHICH THE SEARCH CALLS AT EVERY NODE IT COVERS, HOLDS ONE
+#if defined(CHECK_ALLOC)
+thread_local uint64_t allocationCount = 0;
+
+// KEPT OUT OF LINE, OR GCC WARNS THAT free IS GIVEN A POINTER FROM new
+__attribute__((noinline)) void* operator new(size_t size) {
+    allocationCount++;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+#endif
+
+class AllocationGuard {
+public:
+#if defined(CHECK_ALLOC)
+    explicit AllocationGuard(const char* where) : where(where), start(allocationCount) {}
+
+    ~AllocationGuard() {
+        if (allocationCount != start) {
+            std::cerr << "Heap allocation in " << where << std::endl;
+            std::abort();
+        }
+    }
+
+private:
+    const char* where;
+    uint64_t start;
+#else
+    explicit AllocationGuard(const char*) {}
+#endif
+};
+
+// NO POSITION HAS MORE THAN 218 LEGAL MOVES
+const int MAX_MOVES = 256;
+
+// FIXED-CAPACITY LIST OF MOVES THAT LIVES ON THE STACK (OR INSIDE ITS OWNER), SO GENERATING MOVES NEVER ALLOCATES
+class MoveList {
+public:
+    MoveList() : count(0) {}
+
+    void add(Move move) {
+        moves[count++] = move;
+    }
+
+    void clear() {
+        count = 0;
+    }
+
+    int size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    Move operator[](int i) const {
+        return moves[i];
+    }
+
+    Move& operator[](int i) {
+        return moves[i];
+    }
+
+    const Move* begin() const {
+        return moves;
+    }
+
+    const Move* end() const {
+        return moves + count;
+    }
+
+    // DROPS EVERYTHING FROM INDEX n ONWARDS
+    void resize(int n) {
+        count = n;
+    }
+
+private:
+    Move moves[MAX_MOVES];
+    int count;
+};
+
+// CASTLING RIGHTS AS A 4-BIT MASK
+enum CastlingRights {
+    NO_CASTLING,
+    WHITE_OO = 1,
+    WHITE_OOO = 2,
+    BLACK_OO = 4,
+    BLACK_OOO = 8,
+    WHITE_CASTLING = WHITE_OO | WHITE_OOO,
+    BLACK_CASTLING = BLACK_OO | BLACK_OOO,
+    ALL_CASTLING = WHITE_CASTLING | BLACK_CASTLING
+};
+
+// THE CASTLING RIGHTS LOST WHEN A MOVE STARTS OR ENDS ON EACH SQUARE: THE KING'S SQUARE TAKES BOTH RIGHTS OF
+// ITS SIDE, A ROOK'S CORNER TAKES THE ONE ON ITS WING, AND EVERY OTHER SQUARE TAKES NONE
+constexpr int castlingRightsMask[64] = {
+    WHITE_OOO, 0, 0, 0, WHITE_CASTLING, 0, 0, WHITE_OO,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    BLACK_OOO, 0, 0, 0, BLACK_CASTLING, 0, 0, BLACK_OO
+};
+
+// FOR EACH CASTLING MOVE: ITS RIGHT, THE KING'S MOVE, THE SQUARES THAT MUST BE EMPTY AND THE SQUARES THE KING
+// PASSES OVER OR LANDS ON, WHICH MUST NOT BE ATTACKED
+struct CastlingPath {
+    CastlingRights right;
+    Square kingFrom, kingTo;
+    Bitboard empty, kingPath;
+};
+
+constexpr CastlingPath castlingPaths[COLOR_NB][2] = {
+    {{WHITE_OO,  SQ_E1, SQ_G1, 0x60ULL,       0x60ULL},
+     {WHITE_OOO, SQ_E1, SQ_C1, 0x0EULL,       0x0CULL}},
+    {{BLACK_OO,  SQ_E8, SQ_G8, 0x60ULL << 56, 0x60ULL << 56},
+     {BLACK_OOO, SQ_E8, SQ_C8, 0x0EULL << 56, 0x0CULL << 56}}
+};
+
+// THE PIECES A MOVE TOOK OFF, PUT ON OR MOVED: PIECE i WENT FROM from[i] TO to[i], EITHER BEING SQ_NONE FOR A PIECE
+// THAT LEFT OR JOINED THE BOARD. A CAPTURING PROMOTION TOUCHES THREE
+struct DirtyPieces {
+    int count;
+    PieceCode piece[3];
+    Square from[3];
+    Square to[3];
+
+    void add(PieceCode pc, Square f, Square t) {
+        piece[count] = pc;
+        from[count] = f;
+        to[count] = t;
+        count++;
+    }
+};
+
+// WHAT makeMove SAVES SO THAT unmakeMove CAN RESTORE THE POSITION WITHOUT RECOMPUTING ANYTHING, AND THE PIECES THE
+// MOVE CHANGED, FOR THE NETWORK ACCUMULATORS
+struct StateInfo {
+    PieceCode captured;
+    int castlingRights;
+    Square epSquare;
+    int rule50;
+    uint64_t key;
+    DirtyPieces dirty;
+};
+
+// PRECOMPUTED ATTACKS OF THE NON-SLIDING PIECES FOR EVERY SQUARE
+Bitboard pawnAttacks[COLOR_NB][SQUARE_NB];
+Bitboard knightAttacks[SQUARE_NB];
+Bitboard kingAttacks[SQUARE_NB];
+
+// RAY DIRECTIONS AS {ROW, COLUMN} STEPS
+constexpr int bishopDirections[4][2] = {{-1, 1}, {1, 1}, {1, -1}, {-1, -1}};
+constexpr int rookDirections[4][2] = {{-1, 0}, {0, 1}, {1, 0}, {0, -1}};
+
+// ADDS THE SQUARE AT (y, x) TO THE BITBOARD IF IT LIES ON THE BOARD
+Bitboard safeSquareBB(int y, int x) {
+    return (y >= 0 && y < 8 && x >= 0 && x < 8) ? squareBB(makeSquare(y, x)) : 0;
+}
+
+void initBitboards() {
+    int knightOffsetX[8] = {1, 2, 2, 1, -1, -2, -2, -1};
+    int knightOffsetY[8] = {-2, -1, 1, 2, 2, 1, -1, -2};
+    int kingOffsetX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    int kingOffsetY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+    for (int s = SQ_A1; s <= SQ_H8; s++) {
+        int y = rowOf(Square(s));
+        int x = colOf(Square(s));
+
+        pawnAttacks[WHITE][s] = safeSquareBB(y - 1, x - 1) | safeSquareBB(y - 1, x + 1);
+        pawnAttacks[BLACK][s] = safeSquareBB(y + 1, x - 1) | safeSquareBB(y + 1, x + 1);
+
+        knightAttacks[s] = 0;
+        kingAttacks[s] = 0;
+        for (int i = 0; i < 8; i++) {
+            knightAttacks[s] |= safeSquareBB(y + knightOffsetY[i], x + knightOffsetX[i]);
+            kingAttacks[s] |= safeSquareBB(y + kingOffsetY[i], x + kingOffsetX[i]);
+        }
+    }
+}
+
+// WALKS THE FOUR RAYS OF A BISHOP OR ROOK, STOPPING AT (AND INCLUDING) THE FIRST OCCUPIED SQUARE
+// ONLY USED TO FILL THE MAGIC ATTACK TABLES BELOW
+Bitboard slidingAttacks(PieceType pt, Square s, Bitboard occupied) {
+    const int (*directions)[2] = pt == BISHOP ? bishopDirections : rookDirections;
+    Bitboard attacks = 0;
+
+    for (int i = 0; i < 4; i++) {
+        int newY = rowOf(s) + directions[i][0];
+        int newX = colOf(s) + directions[i][1];
+
+        while (newY >= 0 && newY < 8 && newX >= 0 && newX < 8) {
+            Bitboard b = squareBB(makeSquare(newY, newX));
+            attacks |= b;
+            if (occupied & b) {
+                break;
+            }
+            newY += directions[i][0];
+            newX += directions[i][1];
+        }
+    }
+    return attacks;
+}
+
+// MAGIC BITBOARD ENTRY FOR ONE SQUARE: THE RELEVANT BLOCKER MASK IS HASHED INTO AN ATTACK TABLE SLICE
+// BUILD WITH -DUSE_PEXT -mbmi2 TO INDEX WITH THE BMI2 PEXT INSTRUCTION INSTEAD OF THE MAGIC MULTIPLY
+struct Magic {
+    Bitboard mask;
+    Bitboard magic;
+    Bitboard* attacks;
+    unsigned shift;
+
+    unsigned index(Bitboard occupied) const {
+#if defined(USE_PEXT)
+        return unsigned(_pext_u64(occupied, mask));
+#else
+        return unsigned(((occupied & mask) * magic) >> shift);
+#endif
+    }
+};
+
+Magic bishopMagics[SQUARE_NB];
+Magic rookMagics[SQUARE_NB];
+
+// ALL BLOCKER SUBSETS OF ALL SQUARES SHARE ONE TABLE PER SLIDER
+Bitboard bishopTable[0x1480];
+Bitboard rookTable[0x19000];
+
+inline Bitboard bishopAttacks(Square s, Bitboard occupied) {
+    const Magic& m = bishopMagics[s];
+    return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard rookAttacks(Square s, Bitboard occupied) {
+    const Magic& m = rookMagics[s];
+    return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard queenAttacks(Square s, Bitboard occupied) {
+    return bishopAttacks(s, occupied) | rookAttacks(s, occupied);
+}
+
+// XORSHIFT64* GENERATOR, SEEDED SO THE MAGIC SEARCH IS THE SAME ON EVERY RUN
+class PRNG {
+public:
+    explicit PRNG(uint64_t seed) : state(seed) {}
+
+    uint64_t rand64() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+
+    // FEW BITS SET: GOOD MAGIC CANDIDATES
+    uint64_t sparseRand() {
+        return rand64() & rand64() & rand64();
+    }
+
+private:
+    uint64_t state;
+};
+
+void initMagics(PieceType pt, Magic magics[], Bitboard table[]) {
+#if !defined(USE_PEXT)
+    // ONE SEED PER RANK, PICKED SO THE SEARCH BELOW FINISHES QUICKLY
+    const uint64_t seeds[8] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+
+    Bitboard occupancy[4096];
+    int epoch[4096] = {}, attempt = 0;
+#endif
+    Bitboard reference[4096];
+    Bitboard* next = table;
+
+    for (int s = SQ_A1; s <= SQ_H8; s++) {
+        // BOARD EDGES ARE NOT RELEVANT BLOCKERS UNLESS THE SLIDER STANDS ON THAT EDGE
+        Bitboard rankEdges = (RANK_1_BB | (RANK_1_BB << 56)) & ~(RANK_1_BB << (8 * (s >> 3)));
+        Bitboard fileEdges = (FILE_A_BB | (FILE_A_BB << 7)) & ~(FILE_A_BB << (s & 7));
+
+        Magic& m = magics[s];
+        m.mask = slidingAttacks(pt, Square(s), 0) & ~(rankEdges | fileEdges);
+        m.shift = 64 - popcount(m.mask);
+        m.attacks = next;
+
+        // ENUMERATE EVERY SUBSET OF THE MASK (CARRY-RIPPLER) AND ITS ATTACK SET
+        int size = 0;
+        Bitboard b = 0;
+        do {
+            reference[size] = slidingAttacks(pt, Square(s), b);
+#if defined(USE_PEXT)
+            m.attacks[_pext_u64(b, m.mask)] = reference[size];
+#else
+            occupancy[size] = b;
+#endif
+            size++;
+            b = (b - m.mask) & m.mask;
+        } while (b);
+
+        next += size;
+
+#if !defined(USE_PEXT)
+        // SEARCH FOR A MAGIC THAT MAPS EVERY SUBSET WITHOUT DESTRUCTIVE COLLISIONS
+        PRNG rng(seeds[s >> 3]);
+        for (int i = 0; i < size; ) {
+            m.magic = 0;
+            while (popcount((m.mask * m.magic) >> 56) < 6) {
+                m.magic = rng.sparseRand();
+            }
+
+            for (++attempt, i = 0; i < size; i++) {
+                unsigned idx = m.index(occupancy[i]);
+                if (epoch[idx] < attempt) {
+                    epoch[idx] = attempt;
+                    m.attacks[idx] = reference[i];
+                } else if (m.attacks[idx] != reference[i]) {
+                    break;
+                }
+            }
+        }
+#endif
+    }
+}
+
+// SQUARES ATTACKED BY A PIECE OF THE GIVEN TYPE AND COLOUR STANDING ON s
+Bitboard pieceAttacks(PieceType pt, Color c, Square s, Bitboard occupied) {
+    switch (pt) {
+        case PAWN:   return pawnAttacks[c][s];
+        case KNIGHT: return knightAttacks[s];
+        case BISHOP: return bishopAttacks(s, occupied);
+        case ROOK:   return rookAttacks(s, occupied);
+        case QUEEN:  return queenAttacks(s, occupied);
+        case KING:   return kingAttacks[s];
+        default:     return 0;
+    }
+}
+
+// SQUARES STRICTLY BETWEEN TWO ALIGNED SQUARES, AND THE WHOLE LINE THROUGH THEM (EMPTY IF NOT ALIGNED)
+Bitboard betweenBB[SQUARE_NB][SQUARE_NB];
+Bitboard lineBB[SQUARE_NB][SQUARE_NB];
+
+void initLineTables() {
+    for (int a = SQ_A1; a <= SQ_H8; a++) {
+        for (int b = SQ_A1; b <= SQ_H8; b++) {
+            betweenBB[a][b] = 0;
+            lineBB[a][b] = 0;
+
+            PieceType sliders[2] = {BISHOP, ROOK};
+            for (PieceType pt : sliders) {
+                if (pieceAttacks(pt, WHITE, Square(a), 0) & squareBB(Square(b))) {
+                    lineBB[a][b] = (pieceAttacks(pt, WHITE, Square(a), 0) & pieceAttacks(pt, WHITE, Square(b), 0)) | squareBB(Square(a)) | squareBB(Square(b));
+                    betweenBB[a][b] = pieceAttacks(pt, WHITE, Square(a), squareBB(Square(b))) & pieceAttacks(pt, WHITE, Square(b), squareBB(Square(a)));
+                }
+            }
+        }
+    }
+}
+
+// ZOBRIST KEYS: ONE RANDOM NUMBER PER PIECE ON EACH SQUARE, PER CASTLING-RIGHTS MASK, PER EN PASSANT FILE AND
+// FOR BLACK TO MOVE. A POSITION'S KEY IS THE XOR OF THE NUMBERS THAT APPLY TO IT
+uint64_t zobristPiece[PIECE_CODE_NB][SQUARE_NB];
+uint64_t zobristCastling[16];
+uint64_t zobristEnPassant[8];
+uint64_t zobristSide;
+
+void initZobrist() {
+    PRNG rng(1070372);
+
+    for (int pc = 0; pc < PIECE_CODE_NB; pc++) {
+        for (int s = SQ_A1; s <= SQ_H8; s++) {
+            zobristPiece[pc][s] = rng.rand64();
+        }
+    }
+    for (int cr = 0; cr < 16; cr++) {
+        zobristCastling[cr] = rng.rand64();
+    }
+    for (int f = 0; f < 8; f++) {
+        zobristEnPassant[f] = rng.rand64();
+    }
+    zobristSide = rng.rand64();
+}
+
+// PLAIN PIECE VALUES FOR MOVE ORDERING AND EXCHANGE EVALUATION
+const int pieceValue[PIECE_TYPE_NB] = {0, 100, 320, 330, 500, 900, 0};
+
+// PIECE-SQUARE TABLES. EACH PIECE GETS A MIDDLEGAME AND AN ENDGAME SCORE FOR EVERY SQUARE; THE EVALUATION BLENDS
+// THE TWO BY HOW MUCH MATERIAL IS LEFT. THE TABLES BELOW ARE WRITTEN AS WHITE SEES THE BOARD, RANK 8 FIRST, SO ROW
+// y OF THE TABLE IS THE SAME ROW y AS makeSquare USES
+const int pieceValueMg[PIECE_TYPE_NB] = {0, 82, 337, 365, 477, 1025, 0};
+const int pieceValueEg[PIECE_TYPE_NB] = {0, 94, 281, 297, 512, 936, 0};
+
+// WEIGHT OF EACH PIECE IN THE GAME PHASE; ALL PIECES ON THE BOARD ADD UP TO PHASE_MAX
+const int phaseWeight[PIECE_TYPE_NB] = {0, 0, 1, 1, 2, 4, 0};
+constexpr int PHASE_MAX = 24;
+
+const int pawnPsqMg[SQUARE_NB] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     50,  50,  50,  50,  50,  50,  50,  50,
+     10,  10,  20,  30,  30,  20,  10,  10,
+      5,   5,  10,  25,  25,  10,   5,   5,
+      0,   0,   0,  20,  20,   0,   0,   0,
+      5,  -5, -10,   0,   0, -10,  -5,   5,
+      5,  10,  10, -20, -20,  10,  10,   5,
+      0,   0,   0,   0,   0,   0,   0,   0
+};
+
+const int pawnPsqEg[SQUARE_NB] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     80,  80,  80,  80,  80,  80,  80,  80,
+     50,  50,  50,  50,  50,  50,  50,  50,
+     30,  30,  30,  30,  30,  30,  30,  30,
+     15,  15,  15,  15,  15,  15,  15,  15,
+      5,   5,   5,   5,   5,   5,   5,   5,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0
+};
+
+const int knightPsq[SQUARE_NB] = {
+    -50, -40, -30, -30, -30, -30, -40, -50,
+    -40, -20,   0,   0,   0,   0, -20, -40,
+    -30,   0,  10,  15,  15,  10,   0, -30,
+    -30,   5,  15,  20,  20,  15,   5, -30,
+    -30,   0,  15,  20,  20,  15,   0, -30,
+    -30,   5,  10,  15,  15,  10,   5, -30,
+    -40, -20,   0,   5,   5,   0, -20, -40,
+    -50, -40, -30, -30, -30, -30, -40, -50
+};
+
+const int bishopPsq[SQUARE_NB] = {
+    -20, -10, -10, -10, -10, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,  10,  10,   5,   0, -10,
+    -10,   5,   5,  10,  10,   5,   5, -10,
+    -10,   0,  10,  10,  10,  10,   0, -10,
+    -10,  10,  10,  10,  10,  10,  10, -10,
+    -10,   5,   0,   0,   0,   0,   5, -10,
+    -20, -10, -10, -10, -10, -10, -10, -20
+};
+
+const int rookPsqMg[SQUARE_NB] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+      5,  10,  10,  10,  10,  10,  10,   5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+      0,   0,   0,   5,   5,   0,   0,   0
+};
+
+const int rookPsqEg[SQUARE_NB] = {
+      5,   5,   5,   5,   5,   5,   5,   5,
+     10,  10,  10,  10,  10,  10,  10,  10,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0
+};
+
+const int queenPsq[SQUARE_NB] = {
+    -20, -10, -10,  -5,  -5, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,   5,   5,   5,   0, -10,
+     -5,   0,   5,   5,   5,   5,   0,  -5,
+      0,   0,   5,   5,   5,   5,   0,  -5,
+    -10,   5,   5,   5,   5,   5,   0, -10,
+    -10,   0,   5,   0,   0,   0,   0, -10,
+    -20, -10, -10,  -5,  -5, -10, -10, -20
+};
+
+const int kingPsqMg[SQUARE_NB] = {
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -20, -30, -30, -40, -40, -30, -30, -20,
+    -10, -20, -20, -20, -20, -20, -20, -10,
+     20,  20,   0,   0,   0,   0,  20,  20,
+     20,  30,  10,   0,   0,  10,  30,  20
+};
+
+const int kingPsqEg[SQUARE_NB] = {
+    -50, -40, -30, -20, -20, -30, -40, -50,
+    -30, -20, -10,   0,   0, -10, -20, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -30,   0,   0,   0,   0, -30, -30,
+    -50, -30, -30, -30, -30, -30, -30, -50
+};
+
+// MATERIAL PLUS TABLE SCORE OF EVERY PIECE ON EVERY SQUARE, FROM WHITE'S POINT OF VIEW. BLACK PIECES USE THE WHITE
+// TABLE MIRRORED TOP TO BOTTOM, WITH THE SIGN FLIPPED
+int psqMg[PIECE_CODE_NB][SQUARE_NB];
+int psqEg[PIECE_CODE_NB][SQUARE_NB];
+
+void initPieceSquareTables() {
+    const int* tablesMg[PIECE_TYPE_NB] = {nullptr, pawnPsqMg, knightPsq, bishopPsq, rookPsqMg, queenPsq, kingPsqMg};
+    const int* tablesEg[PIECE_TYPE_NB] = {nullptr, pawnPsqEg, knightPsq, bishopPsq, rookPsqEg, queenPsq, kingPsqEg};
+
+    for (int pt = PAWN; pt <= KING; pt++) {
+        for (int s = SQ_A1; s <= SQ_H8; s++) {
+            // TABLE INDEX OF SQUARE s IS ITS ROW y TIMES 8 PLUS ITS COLUMN, WHICH IS s WITH THE RANK FLIPPED
+            int mg = pieceValueMg[pt] + tablesMg[pt][s ^ 56];
+            int eg = pieceValueEg[pt] + tablesEg[pt][s ^ 56];
+            psqMg[makePiece(WHITE, PieceType(pt))][s] = mg;
+            psqEg[makePiece(WHITE, PieceType(pt))][s] = eg;
+            psqMg[makePiece(BLACK, PieceType(pt))][s ^ 56] = -mg;
+            psqEg[makePiece(BLACK, PieceType(pt))][s ^ 56] = -eg;
+        }
+    }
+}
+
+// NNUE EVALUATION. A HalfKP NETWORK HAS ONE INPUT PER (OWN KING SQUARE, NON-KING PIECE, SQUARE) FOR EACH SIDE'S
+// POINT OF VIEW, 64 * 10 * 64 IN ALL. THE FIRST LAYER SUMS THE WEIGHT ROWS OF THE ACTIVE INPUTS INTO AN int16
+// ACCUMULATOR PER SIDE; A MOVE ONLY TURNS A FEW INPUTS ON OR OFF, SO THE ACCUMULATORS ARE UPDATED, NOT RECOMPUTED.
+// THE OUTPUT IS A DOT PRODUCT OF BOTH ACCUMULATORS, CLIPPED TO [0, NNUE_CLIP], SIDE TO MOVE FIRST
+constexpr int NNUE_INPUTS = SQUARE_NB * 10 * SQUARE_NB;
+constexpr int NNUE_MAX_HIDDEN = 512;
+constexpr int NNUE_CLIP = 127;
+
+// NETWORK FILE: "CHNN", THEN LITTLE-ENDIAN uint32 VERSION (1), uint32 HIDDEN SIZE (A MULTIPLE OF 16, AT MOST
+// NNUE_MAX_HIDDEN), int32 OUTPUT SCALE, int16 FIRST-LAYER BIASES[HIDDEN], int16 FIRST-LAYER WEIGHTS[NNUE_INPUTS][HIDDEN],
+// int16 OUTPUT WEIGHTS[2 * HIDDEN] AND int32 OUTPUT BIAS. THE SCORE IS (DOT PRODUCT + OUTPUT BIAS) / OUTPUT SCALE
+struct Network {
+    int hidden = 0;
+    int outputScale = 1;
+    std::vector<int16_t> biases;
+    std::vector<int16_t> weights;
+    std::vector<int16_t> outputWeights;
+    int32_t outputBias = 0;
+};
+
+// THE NETWORK THE SEARCH EVALUATES WITH WHEN useNNUE IS SET. LOADED ONCE AT START-UP AND READ-ONLY AFTERWARDS
+Network network;
+bool useNNUE = false;
+
+// INDEX OF AN INPUT FROM ONE SIDE'S POINT OF VIEW. BLACK SEES THE BOARD MIRRORED TOP TO BOTTOM, SO THE SAME WEIGHTS
+// SERVE BOTH SIDES
+inline int featureIndex(Color perspective, Square kingSquare, PieceCode pc, Square s) {
+    int flip = perspective == WHITE ? 0 : 56;
+    int kind = typeOf(pc) - PAWN + (colorOf(pc) == perspective ? 0 : 5);
+    return (((kingSquare ^ flip) * 10 + kind) * SQUARE_NB + (s ^ flip)) * network.hidden;
+}
+
+// THE VECTOR KERNELS, PICKED AT START-UP FOR THE CPU THE PROGRAM RUNS ON. hidden IS ALWAYS A MULTIPLE OF 16
+void addRowScalar(int16_t* acc, const int16_t* row, int hidden) {
+    for (int i = 0; i < hidden; i++) {
+        acc[i] += row[i];
+    }
+}
+
+void subRowScalar(int16_t* acc, const int16_t* row, int hidden) {
+    for (int i = 0; i < hidden; i++) {
+        acc[i] -= row[i];
+    }
+}
+
+int32_t outputScalar(const int16_t* us, const int16_t* them, const int16_t* weights, int hidden) {
+    int32_t sum = 0;
+    for (int i = 0; i < hidden; i++) {
+        sum += std::min(std::max(int(us[i]), 0), NNUE_CLIP) * weights[i];
+        sum += std::min(std::max(int(them[i]), 0), NNUE_CLIP) * weights[hidden + i];
+    }
+    return sum;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.1")))
+void addRowSSE41(int16_t* acc, const int16_t* row, int hidden) {
+    for (int i = 0; i < hidden; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i), _mm_add_epi16(a, r));
+    }
+}
+
+__attribute__((target("sse4.1")))
+void subRowSSE41(int16_t* acc, const int16_t* row, int hidden) {
+    for (int i = 0; i < hidden; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i), _mm_sub_epi16(a, r));
+    }
+}
+
+__attribute__((target("sse4.1")))
+int32_t outputSSE41(const int16_t* us, const int16_t* them, const int16_t* weights, int hidden) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i clip = _mm_set1_epi16(NNUE_CLIP);
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < hidden; i += 8) {
+        __m128i u = _mm_min_epi16(_mm_max_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(us + i)), zero), clip);
+        __m128i t = _mm_min_epi16(_mm_max_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(them + i)), zero), clip);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(u, _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i))));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(t, _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + hidden + i))));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+}
+
+__attribute__((target("avx2")))
+void addRowAVX2(int16_t* acc, const int16_t* row, int hidden) {
+    for (int i = 0; i < hidden; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_add_epi16(a, r));
+    }
+}
+
+__attribute__((target("avx2")))
+void subRowAVX2(int16_t* acc, const int16_t* row, int hidden) {
+    for (int i = 0; i < hidden; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_sub_epi16(a, r));
+    }
+}
+
+__attribute__((target("avx2")))
+int32_t outputAVX2(const int16_t* us, const int16_t* them, const int16_t* weights, int hidden) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i clip = _mm256_set1_epi16(NNUE_CLIP);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < hidden; i += 16) {
+        __m256i u = _mm256_min_epi16(_mm256_max_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(us + i)), zero), clip);
+        __m256i t = _mm256_min_epi16(_mm256_max_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(them + i)), zero), clip);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(u, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i))));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(t, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + hidden + i))));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+    return _mm_cvtsi128_si32(half);
+}
+#endif
+
+struct NnueKernels {
+    const char* name;
+    void (*addRow)(int16_t*, const int16_t*, int);
+    void (*subRow)(int16_t*, const int16_t*, int);
+    int32_t (*output)(const int16_t*, const int16_t*, const int16_t*, int);
+};
+
+NnueKernels nnueKernels = {"scalar", addRowScalar, subRowScalar, outputScalar};
+
+void initNnueKernels() {
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("avx2")) {
+        nnueKernels = {"avx2", addRowAVX2, subRowAVX2, outputAVX2};
+    } else if (__builtin_cpu_supports("sse4.1")) {
+        nnueKernels = {"sse4.1", addRowSSE41, subRowSSE41, outputSSE41};
+    }
+#endif
+}
+
+// THE BUNDLED NETWORK, BUILT HERE RATHER THAN SHIPPED AS A FILE. ITS 16 NEURONS PER SIDE COUNT THAT SIDE'S PAWNS,
+// KNIGHTS, BISHOPS, ROOKS AND QUEENS AND SUM A QUARTER OF THEIR MIDDLEGAME TABLE SCORES, SO IT SCORES MATERIAL AND
+// PIECE PLACEMENT LIKE THE HAND-WRITTEN EVALUATION (WITHOUT ITS KING TABLES OR ENDGAME TAPER). A TRAINED NETWORK
+// FILE IS WHAT MAKES THE NNUE EVALUATION STRONGER
+void makeDefaultNetwork(Network& net) {
+    const int* tables[PIECE_TYPE_NB] = {nullptr, pawnPsqMg, knightPsq, bishopPsq, rookPsqMg, queenPsq, nullptr};
+    // TABLE SCORES ARE OFFSET BY THE BIAS SO THEY STAY INSIDE THE CLIPPED RANGE; THE OFFSETS OF THE TWO SIDES CANCEL
+    constexpr int tableBias = 64;
+    constexpr int tableScale = 4;
+
+    net.hidden = 16;
+    net.outputScale = 1;
+    net.outputBias = 0;
+    net.biases.assign(net.hidden, 0);
+    net.weights.assign(size_t(NNUE_INPUTS) * net.hidden, 0);
+    net.outputWeights.assign(2 * net.hidden, 0);
+
+    for (int pt = PAWN; pt <= QUEEN; pt++) {
+        int countNeuron = pt - PAWN;
+        int tableNeuron = 5 + pt - PAWN;
+        net.biases[tableNeuron] = tableBias;
+        net.outputWeights[countNeuron] = pieceValueMg[pt];
+        net.outputWeights[net.hidden + countNeuron] = -pieceValueMg[pt];
+        net.outputWeights[tableNeuron] = tableScale;
+        net.outputWeights[net.hidden + tableNeuron] = -tableScale;
+
+        // ONLY THE SIDE'S OWN PIECES FEED ITS NEURONS; FEATURES ARE WRITTEN FOR WHITE, WHICH THE MIRRORING SHARES
+        // WITH BLACK. THE TABLES ARE RANK 8 FIRST, HENCE s ^ 56
+        for (int k = SQ_A1; k <= SQ_H8; k++) {
+            for (int s = SQ_A1; s <= SQ_H8; s++) {
+                int16_t* row = &net.weights[(size_t(k * 10 + pt - PAWN) * SQUARE_NB + s) * net.hidden];
+                row[countNeuron] = 1;
+                row[tableNeuron] = int16_t(tables[pt][s ^ 56] / tableScale);
+            }
+        }
+    }
+}
+
+// READS A NETWORK FILE IN THE FORMAT ABOVE; "builtin" SELECTS THE BUNDLED NETWORK
+bool loadNetwork(const std::string& path, Network& net) {
+    if (path == "builtin") {
+        makeDefaultNetwork(net);
+        return true;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    char magic[4];
+    uint32_t version, hidden;
+    int32_t scale;
+    if (!in.read(magic, 4) || std::memcmp(magic, "CHNN", 4) != 0
+        || !in.read(reinterpret_cast<char*>(&version), 4) || version != 1
+        || !in.read(reinterpret_cast<char*>(&hidden), 4) || hidden == 0 || hidden % 16 != 0 || hidden > NNUE_MAX_HIDDEN
+        || !in.read(reinterpret_cast<char*>(&scale), 4) || scale <= 0) {
+        return false;
+    }
+
+    net.hidden = int(hidden);
+    net.outputScale = scale;
+    net.biases.resize(hidden);
+    net.weights.resize(size_t(NNUE_INPUTS) * hidden);
+    net.outputWeights.resize(2 * hidden);
+    in.read(reinterpret_cast<char*>(net.biases.data()), std::streamsize(net.biases.size() * sizeof(int16_t)));
+    in.read(reinterpret_cast<char*>(net.weights.data()), std::streamsize(net.weights.size() * sizeof(int16_t)));
+    in.read(reinterpret_cast<char*>(net.outputWeights.data()), std::streamsize(net.outputWeights.size() * sizeof(int16_t)));
+    in.read(reinterpret_cast<char*>(&net.outputBias), sizeof(net.outputBias));
+    return bool(in);
+}
+
+// WRITES A NETWORK IN THE FILE FORMAT ABOVE
+bool saveNetwork(const std::string& path, const Network& net) {
+    std::ofstream out(path, std::ios::binary);
+    uint32_t version = 1, hidden = uint32_t(net.hidden);
+    int32_t scale = net.outputScale;
+    out.write("CHNN", 4);
+    out.write(reinterpret_cast<const char*>(&version), 4);
+    out.write(reinterpret_cast<const char*>(&hidden), 4);
+    out.write(reinterpret_cast<const char*>(&scale), 4);
+    out.write(reinterpret_cast<const char*>(net.biases.data()), std::streamsize(net.biases.size() * sizeof(int16_t)));
+    out.write(reinterpret_cast<const char*>(net.weights.data()), std::streamsize(net.weights.size() * sizeof(int16_t)));
+    out.write(reinterpret_cast<const char*>(net.outputWeights.data()), std::streamsize(net.outputWeights.size() * sizeof(int16_t)));
+    out.write(reinterpret_cast<const char*>(&net.outputBias), sizeof(net.outputBias));
+    return bool(out);
+}
+
+// BOTH SIDES' ACCUMULATORS FOR ONE POSITION OF THE GAME. key[c] IS THE ZOBRIST KEY OF THE POSITION THE SIDE-c
+// ACCUMULATOR WAS COMPUTED FOR, SO AN ENTRY LEFT OVER FROM ANOTHER LINE OF PLAY IS RECOGNISED AS STALE
+struct Accumulator {
+    alignas(64) int16_t values[COLOR_NB][NNUE_MAX_HIDDEN];
+    uint64_t key[COLOR_NB];
+};
+
+// POSITION: ONE BITBOARD PER PIECE TYPE AND COLOUR, OCCUPANCY BITBOARDS AND A BYTE MAILBOX
+class Position {
+public:
+    Position() {
+        clear();
+    }
+
+    void clear() {
+        std::memset(byColorType, 0, sizeof(byColorType));
+        std::memset(byColor, 0, sizeof(byColor));
+        occupied = 0;
+        std::memset(board, NO_PIECE, sizeof(board));
+    }
+
+    void putPiece(PieceCode pc, Square s) {
+        Bitboard b = squareBB(s);
+        byColorType[colorOf(pc)][typeOf(pc)] |= b;
+        byColor[colorOf(pc)] |= b;
+        occupied |= b;
+        board[s] = pc;
+    }
+
+    void removePiece(Square s) {
+        PieceCode pc = pieceOn(s);
+        Bitboard b = squareBB(s);
+        byColorType[colorOf(pc)][typeOf(pc)] &= ~b;
+        byColor[colorOf(pc)] &= ~b;
+        occupied &= ~b;
+        board[s] = NO_PIECE;
+    }
+
+    // MOVES A PIECE TO AN EMPTY SQUARE
+    void movePiece(Square from, Square to) {
+        PieceCode pc = pieceOn(from);
+        Bitboard fromTo = squareBB(from) | squareBB(to);
+        byColorType[colorOf(pc)][typeOf(pc)] ^= fromTo;
+        byColor[colorOf(pc)] ^= fromTo;
+        occupied ^= fromTo;
+        board[from] = NO_PIECE;
+        board[to] = pc;
+    }
+
+    PieceCode pieceOn(Square s) const {
+        return PieceCode(board[s]);
+    }
+
+    bool isEmpty(Square s) const {
+        return board[s] == NO_PIECE;
+    }
+
+    Bitboard pieces() const {
+        return occupied;
+    }
+
+    Bitboard pieces(Color c) const {
+        return byColor[c];
+    }
+
+    Bitboard pieces(Color c, PieceType pt) const {
+        return byColorType[c][pt];
+    }
+
+    Bitboard pieces(PieceType pt) const {
+        return byColorType[WHITE][pt] | byColorType[BLACK][pt];
+    }
+
+    Square kingSquare(Color c) const {
+        return lsb(byColorType[c][KING]);
+    }
+
+    // PIECES OF EITHER COLOUR ATTACKING A SQUARE, WITH SLIDERS BLOCKED BY THE GIVEN OCCUPANCY
+    Bitboard attackersTo(Square s, Bitboard occupied) const {
+        return (pawnAttacks[BLACK][s] & byColorType[WHITE][PAWN])
+             | (pawnAttacks[WHITE][s] & byColorType[BLACK][PAWN])
+             | (knightAttacks[s] & pieces(KNIGHT))
+             | (bishopAttacks(s, occupied) & (pieces(BISHOP) | pieces(QUEEN)))
+             | (rookAttacks(s, occupied) & (pieces(ROOK) | pieces(QUEEN)))
+             | (kingAttacks[s] & pieces(KING));
+    }
+
+    // TWO-CHARACTER ID USED WHEN DISPLAYING THE BOARD ("WP", "BK", "-")
+    std::string pieceID(Square s) const {
+        PieceCode pc = pieceOn(s);
+        if (pc == NO_PIECE) {
+            return "-";
+        }
+        return std::string(1, colorOf(pc) == WHITE ? 'W' : 'B') + " PNBRQK"[typeOf(pc)];
+    }
+
+private:
+    Bitboard byColorType[COLOR_NB][PIECE_TYPE_NB];
+    Bitboard byColor[COLOR_NB];
+    Bitboard occupied;
+    uint8_t board[SQUARE_NB];
+};
+
+// ATTACK MAP: WHAT EVERY PIECE ATTACKS, HOW MANY PIECES OF EACH SIDE HIT EACH SQUARE, AND THE UNION PER SIDE.
+// IT IS BUILT ONCE PER POSITION AND THEN KEPT UP TO DATE BY makeMove/unmakeMove: BEFORE A MOVE THE PIECES ON THE
+// CHANGED SQUARES AND THE SLIDERS WHOSE RAYS REACH THEM ARE LIFTED OUT, AFTERWARDS THEY ARE DROPPED BACK IN
+class AttackMap {
+public:
+    void build(const Position& position) {
+        std::memset(attacksFrom, 0, sizeof(attacksFrom));
+        std::memset(counts, 0, sizeof(counts));
+        byColor[WHITE] = byColor[BLACK] = 0;
+
+        for (Bitboard b = position.pieces(); b; ) {
+            Square s = popLsb(b);
+            addAttacks(position.pieceOn(s), s, position.pieces());
+        }
+    }
+
+    // SQUARES ATTACKED BY A SIDE
+    Bitboard attacks(Color c) const {
+        return byColor[c];
+    }
+
+    // NUMBER OF PIECES OF A SIDE ATTACKING A SQUARE
+    int count(Color c, Square s) const {
+        return counts[c][s];
+    }
+
+    // SQUARES ATTACKED BY THE PIECE STANDING ON A SQUARE
+    Bitboard attacksOf(Square s) const {
+        return attacksFrom[s];
+    }
+
+    // CALLED BEFORE THE PIECES ON THE CHANGED SQUARES MOVE; RETURNS THE SLIDERS THAT HAVE TO BE DROPPED BACK IN
+    Bitboard lift(const Position& position, Bitboard changed) {
+        Bitboard sliders = slidersThrough(position, changed) & ~changed;
+
+        for (Bitboard b = (position.pieces() & changed) | sliders; b; ) {
+            Square s = popLsb(b);
+            removeAttacks(colorOf(position.pieceOn(s)), s);
+        }
+        return sliders;
+    }
+
+    // CALLED AFTER THE MOVE WITH THE SAME CHANGED SQUARES AND THE SLIDERS RETURNED BY lift
+    void drop(const Position& position, Bitboard changed, Bitboard sliders) {
+        for (Bitboard b = (position.pieces() & changed) | sliders; b; ) {
+            Square s = popLsb(b);
+            addAttacks(position.pieceOn(s), s, position.pieces());
+        }
+    }
+
+private:
+    Bitboard attacksFrom[SQUARE_NB];
+    uint8_t counts[COLOR_NB][SQUARE_NB];
+    Bitboard byColor[COLOR_NB];
+
+    // SLIDERS OF EITHER COLOUR WHOSE RAYS REACH ANY OF THE GIVEN SQUARES
+    Bitboard slidersThrough(const Position& position, Bitboard squares) const {
+        Bitboard diagonal = position.pieces(BISHOP) | position.pieces(QUEEN);
+        Bitboard straight = position.pieces(ROOK) | position.pieces(QUEEN);
+        Bitboard sliders = 0;
+
+        while (squares) {
+            Square s = popLsb(squares);
+            sliders |= (bishopAttacks(s, position.pieces()) & diagonal) | (rookAttacks(s, position.pieces()) & straight);
+        }
+        return sliders;
+    }
+
+    void addAttacks(PieceCode pc, Square s, Bitboard occupied) {
+        Color c = colorOf(pc);
+        Bitboard attacks = pieceAttacks(typeOf(pc), c, s, occupied);
+        attacksFrom[s] = attacks;
+        byColor[c] |= attacks;
+
+        while (attacks) {
+            counts[c][popLsb(attacks)]++;
+        }
+    }
+
+    void removeAttacks(Color c, Square s) {
+        Bitboard attacks = attacksFrom[s];
+        attacksFrom[s] = 0;
+
+        while (attacks) {
+            Square target = popLsb(attacks);
+            if (--counts[c][target] == 0) {
+                byColor[c] &= ~squareBB(target);
+            }
+        }
+    }
+};
+
+class Piece {
+public:
+    Piece(std::string color, int y, int x) : color(color), y(y), x(x) {}
+
+    // DESTRUCTOR
+    virtual ~Piece() {}
+    
+    // Functions to retrieve type, color, and position
+    virtual std::string getType() const {
+        return "Piece"; // Override this in derived classes
+    }
+
+    std::string getColor() const {
+        return color;
+    }
+
+    int getRowIndex() const {
+        return y;
+    }
+
+    int getColIndex() const {
+        return x;
+    }
+
+    std::string getPosition() const {
+        return convertToAlgebraicNotationPos(y, x);
+    }
+
+    void setRow(int newY) {
+        y = newY;
+    }
+
+    void setCol(int newX) {
+        x = newX;
+    }
+
+protected:
+    std::string color;
+    int x, y;
+};
+
+class Pawn : public Piece {
+public:
+    Pawn(std::string color, int y, int x) : Piece(color, y, x) {}
+    // Implement Pawn-specific move logic here
+
+    // Override getType() to return "Pawn"  
+    std::string getType() const override {
+        return "Pawn";
+    }
+};
+
+class Knight : public Piece {
+public:
+    Knight(std::string color, int y, int x) : Piece(color, y, x) {}
+    // Implement Pawn-specific move logic here
+
+    // Override getType() to return "Knight"
+    std::string getType() const override {
+        return "Knight";
+    }
+};
+
+class Bishop : public Piece {
+public:
+    Bishop(std::string color, int y, int x) : Piece(color, y, x) {}
+    // Implement Pawn-specific move logic here
+
+    // Override getType() to return "Bishop"
+    std::string getType() const override {
+        return "Bishop";
+    }
+};
+
+class Rook : public Piece {
+public:
+    Rook(std::string color, int y, int x) : Piece(color, y, x) {}
+    // Implement Pawn-specific move logic here
+
+    // Override getType() to return "Rook"
+    std::string getType() const override {
+        return "Rook";
+    }
+};
+
+class Queen : public Piece {
+public:
+    Queen(std::string color, int y, int x) : Piece(color, y, x) {}
+    // Implement Pawn-specific move logic here
+
+    // Override getType() to return "Queen"
+    std::string getType() const override {
+        return "Queen";
+    }
+};
+
+class King : public Piece {
+public:
+    King(std::string color, int y, int x) : Piece(color, y, x) {}
+    // Implement Pawn-specific move logic here
+
+    // Override getType() to return "King"
+    std::string getType() const override {
+        return "King";
+    }
+};
+
+// MOVE GENERATION, SPECIALISED AT COMPILE TIME PER SIDE AND PIECE TYPE. THE CALLER WORKS OUT WHICH SQUARES ARE
+// ALLOWED (target), WHICH OF OUR PIECES ARE PINNED TO THE KING ON ksq, AND WHICH PAWNS MAY CAPTURE EN PASSANT
+
+// WHICH MOVES TO GENERATE: CAPTURES (WITH EN PASSANT AND EVERY PROMOTION), THE REMAINING QUIET MOVES, OR BOTH
+enum GenType { CAPTURES, QUIETS, ALL_MOVES };
+
+// PAWN PUSH DIRECTION AND PAWN RANKS PER SIDE
+constexpr int pawnPush[COLOR_NB] = {8, -8};
+constexpr Bitboard pawnDoublePushRank[COLOR_NB] = {RANK_3_BB, RANK_6_BB};
+constexpr Bitboard pawnPromotionRank[COLOR_NB] = {RANK_8_BB, RANK_1_BB};
+
+template<int D>
+constexpr Bitboard shift(Bitboard b) {
+    return D > 0 ? b << D : b >> -D;
+}
+
+template<PieceType Pt>
+inline Bitboard attacksBB(Square s, Bitboard occupied) {
+    if constexpr (Pt == KNIGHT) {
+        return knightAttacks[s];
+    } else if constexpr (Pt == BISHOP) {
+        return bishopAttacks(s, occupied);
+    } else if constexpr (Pt == ROOK) {
+        return rookAttacks(s, occupied);
+    } else {
+        return queenAttacks(s, occupied);
+    }
+}
+
+// ADDS A MOVE FROM THE GIVEN SQUARE TO EVERY TARGET SQUARE
+inline void addPieceMoves(MoveList& moveList, Square from, Bitboard targets) {
+    while (targets) {
+        moveList.add(Move(from, popLsb(targets)));
+    }
+}
+
+template<Color Us, GenType Type>
+void generatePawnMoves(MoveList& moveList, const Position& position, Bitboard target, Bitboard pinned, Square ksq, Bitboard epCapturers, Square epSquare) {
+    constexpr int Up = pawnPush[Us];
+    Bitboard empty = ~position.pieces();
+
+    for (Bitboard pawns = position.pieces(Us, PAWN); pawns; ) {
+        Square from = popLsb(pawns);
+
+        // ONE STEP FORWARD, AND A SECOND ONE FROM THE STARTING RANK, ONTO EMPTY SQUARES; DIAGONAL CAPTURES
+        Bitboard push = shift<Up>(squareBB(from)) & empty;
+        Bitboard pushes = push | (shift<Up>(push & pawnDoublePushRank[Us]) & empty);
+        Bitboard captures = pawnAttacks[Us][from] & position.pieces(~Us);
+        Bitboard targets = Type == CAPTURES ? captures | (pushes & pawnPromotionRank[Us])
+                         : Type == QUIETS ? pushes & ~pawnPromotionRank[Us]
+                         : pushes | captures;
+
+        targets &= target;
+        if (pinned & squareBB(from)) {
+            targets &= lineBB[ksq][from];
+        }
+
+        // ONE MOVE FOR EACH PROMOTION PIECE
+        for (Bitboard promotions = targets & pawnPromotionRank[Us]; promotions; ) {
+            Square to = popLsb(promotions);
+            moveList.add(Move(from, to, PROMOTION, QUEEN));
+            moveList.add(Move(from, to, PROMOTION, ROOK));
+            moveList.add(Move(from, to, PROMOTION, KNIGHT));
+            moveList.add(Move(from, to, PROMOTION, BISHOP));
+        }
+        addPieceMoves(moveList, from, targets & ~pawnPromotionRank[Us]);
+
+        if (Type != QUIETS && (epCapturers & squareBB(from))) {
+            moveList.add(Move(from, epSquare, EN_PASSANT));
+        }
+    }
+}
+
+template<Color Us, PieceType Pt>
+void generatePieceMoves(MoveList& moveList, const Position& position, Bitboard target, Bitboard pinned, Square ksq) {
+    static_assert(Pt != PAWN && Pt != KING, "pawns and kings have their own generators");
+
+    for (Bitboard pieces = position.pieces(Us, Pt); pieces; ) {
+        Square from = popLsb(pieces);
+        Bitboard targets = attacksBB<Pt>(from, position.pieces()) & target;
+        if (pinned & squareBB(from)) {
+            targets &= lineBB[ksq][from];
+        }
+        addPieceMoves(moveList, from, targets);
+    }
+}
+
+// EVERY NON-KING MOVE OF ONE SIDE OF THE GIVEN TYPE; target IS WHERE THE MOVES MAY GO WHETHER OR NOT THEY CAPTURE
+template<Color Us, GenType Type>
+void generatePieceMoves(MoveList& moveList, const Position& position, Bitboard target, Bitboard pinned, Square ksq, Bitboard epCapturers, Square epSquare) {
+    generatePawnMoves<Us, Type>(moveList, position, target, pinned, ksq, epCapturers, epSquare);
+
+    Bitboard pieceTarget = Type == CAPTURES ? target & position.pieces(~Us) : Type == QUIETS ? target & ~position.pieces() : target;
+    generatePieceMoves<Us, KNIGHT>(moveList, position, pieceTarget, pinned, ksq);
+    generatePieceMoves<Us, BISHOP>(moveList, position, pieceTarget, pinned, ksq);
+    generatePieceMoves<Us, ROOK>(moveList, position, pieceTarget, pinned, ksq);
+    generatePieceMoves<Us, QUEEN>(moveList, position, pieceTarget, pinned, ksq);
+}
+
+// CREATES THE PIECE OBJECT MATCHING A MAILBOX PIECE CODE
+std::shared_ptr<Piece> createPiece(PieceCode pc, int y, int x) {
+    std::string color = colorOf(pc) == WHITE ? "White" : "Black";
+    switch (typeOf(pc)) {
+        case PAWN:   return std::make_shared<Pawn>(color, y, x);
+        case KNIGHT: return std::make_shared<Knight>(color, y, x);
+        case BISHOP: return std::make_shared<Bishop>(color, y, x);
+        case ROOK:   return std::make_shared<Rook>(color, y, x);
+        case QUEEN:  return std::make_shared<Queen>(color, y, x);
+        case KING:   return std::make_shared<King>(color, y, x);
+        default:     return nullptr;
+    }
+}
+
+class Chessboard {
+public:
+    Chessboard() = default;
+
+    // A DEEP COPY WITH PIECE OBJECTS OF ITS OWN, SO THE COPY CAN BE PLAYED ON, E.G. BY ANOTHER SEARCH THREAD,
+    // WITHOUT TOUCHING THE ORIGINAL. THE STATE STACK COMES ALONG, SO REPETITIONS OF EARLIER POSITIONS ARE STILL SEEN
+    // AND THE MOVES PLAYED BEFORE THE COPY CAN STILL BE TAKEN BACK
+    Chessboard(const Chessboard& other)
+        : chessboard(other.chessboard), sideToMove(other.sideToMove), castlingRights(other.castlingRights),
+          epSquare(other.epSquare), rule50(other.rule50), key(other.key), scoreMg(other.scoreMg),
+          scoreEg(other.scoreEg), phase(other.phase), attackMap(other.attackMap), movesLog(other.movesLog),
+          gamePly(other.gamePly), stateStack(other.stateStack), whiteLegalMoves(other.whiteLegalMoves),
+          blackLegalMoves(other.blackLegalMoves) {
+        std::fill(pieceAt, pieceAt + SQUARE_NB, nullptr);
+        std::copy(other.listIndex, other.listIndex + SQUARE_NB, listIndex);
+
+        for (const std::shared_ptr<Piece>& piece : other.whitePieces) {
+            whitePieces.push_back(copyPiece(*piece));
+        }
+        for (const std::shared_ptr<Piece>& piece : other.blackPieces) {
+            blackPieces.push_back(copyPiece(*piece));
+        }
+
+        // PIECES WAITING ON THE TAKEBACK STACKS KEEP THE SQUARE THEY LEFT THE BOARD FROM
+        int next = 0;
+        for (const StateInfo& st : stateStack) {
+            if (st.captured != NO_PIECE) {
+                const Piece& piece = *other.capturedPieces[next++];
+                capturedPieces.push_back(createPiece(st.captured, piece.getRowIndex(), piece.getColIndex()));
+            }
+        }
+        for (const std::shared_ptr<Piece>& pawn : other.promotedPawns) {
+            promotedPawns.push_back(createPiece(pawn->getColor() == "White" ? W_PAWN : B_PAWN, pawn->getRowIndex(), pawn->getColIndex()));
+        }
+    }
+
+    Chessboard& operator=(const Chessboard&) = delete;
+
+    // SETTING UP THE CHESSBOARD
+    void initializeBoard() {
+        loadFEN(START_FEN);
+    }
+
+    // SETS UP THE POSITION DESCRIBED BY A FEN STRING. THE MOVE COUNTERS MAY BE LEFT OUT. NOTHING IS ALLOCATED ONCE
+    // THE BOARD HAS BEEN SET UP BEFORE: PIECE OBJECTS ARE RECYCLED THROUGH sparePieces AND THE STACKS KEEP THEIR
+    // CAPACITY. RETURNS FALSE, LEAVING THE BOARD AS IT WAS, IF THE STRING CAN'T BE READ
+    bool loadFEN(const char* fen) {
+        const char* p = fen;
+        Position position;
+
+        // PIECE PLACEMENT, RANK 8 FIRST
+        while (*p == ' ') {
+            p++;
+        }
+        int y = 0, x = 0;
+        for (; *p && *p != ' '; p++) {
+            if (*p == '/') {
+                if (x != 8) {
+                    return false;
+                }
+                y++;
+                x = 0;
+            } else if (*p >= '1' && *p <= '8') {
+                x += *p - '0';
+            } else {
+                bool white = *p >= 'A' && *p <= 'Z';
+                PieceType pt = pieceTypeFromChar(white ? *p : char(*p - 'a' + 'A'));
+                if (pt == NO_PIECE_TYPE || y > 7 || x > 7) {
+                    return false;
+                }
+                position.putPiece(makePiece(white ? WHITE : BLACK, pt), makeSquare(y, x));
+                x++;
+            }
+            if (x > 8) {
+                return false;
+            }
+        }
+        if (y != 7 || x != 8 || popcount(position.pieces(WHITE, KING)) != 1 || popcount(position.pieces(BLACK, KING)) != 1) {
+            return false;
+        }
+
+        // SIDE TO MOVE
+        while (*p == ' ') {
+            p++;
+        }
+        if (*p != 'w' && *p != 'b') {
+            return false;
+        }
+        Color side = *p++ == 'b' ? BLACK : WHITE;
+
+        // CASTLING RIGHTS, DROPPING ANY WHOSE KING OR ROOK IS NOT ON ITS HOME SQUARE
+        while (*p == ' ') {
+            p++;
+        }
+        int rights = 0;
+        for (; *p && *p != ' '; p++) {
+            switch (*p) {
+                case 'K': rights |= WHITE_OO; break;
+                case 'Q': rights |= WHITE_OOO; break;
+                case 'k': rights |= BLACK_OO; break;
+                case 'q': rights |= BLACK_OOO; break;
+                case '-': break;
+                default: return false;
+            }
+        }
+        if (position.pieceOn(SQ_E1) != W_KING) {
+            rights &= ~WHITE_CASTLING;
+        }
+        if (position.pieceOn(SQ_E8) != B_KING) {
+            rights &= ~BLACK_CASTLING;
+        }
+        if (position.pieceOn(SQ_H1) != W_ROOK) {
+            rights &= ~WHITE_OO;
+        }
+        if (position.pieceOn(SQ_A1) != W_ROOK) {
+            rights &= ~WHITE_OOO;
+        }
+        if (position.pieceOn(SQ_H8) != B_ROOK) {
+            rights &= ~BLACK_OO;
+        }
+        if (position.pieceOn(SQ_A8) != B_ROOK) {
+            rights &= ~BLACK_OOO;
+        }
+
+        // EN PASSANT SQUARE, WHICH MUST BE ON THE SIXTH RANK OF THE SIDE TO MOVE. IT IS ONLY KEPT IF THE OTHER SIDE
+        // COULD JUST HAVE PUSHED A PAWN TWO SQUARES PAST IT AND, LIKE IN makeMove, A PAWN CAN ACTUALLY CAPTURE ONTO IT
+        while (*p == ' ') {
+            p++;
+        }
+        Square ep = SQ_NONE;
+        if (*p == '-') {
+            p++;
+        } else if (p[0] >= 'a' && p[0] <= 'h' && p[1] == (side == WHITE ? '6' : '3')) {
+            Square s = Square((p[1] - '1') * 8 + (p[0] - 'a'));
+            Square pushed = Square(side == WHITE ? s - 8 : s + 8);
+            Square origin = Square(side == WHITE ? s + 8 : s - 8);
+            if (position.pieceOn(pushed) == makePiece(~side, PAWN) && position.isEmpty(s) && position.isEmpty(origin)
+                && (pawnAttacks[~side][s] & position.pieces(side, PAWN))) {
+                ep = s;
+            }
+            p += 2;
+        } else {
+            return false;
+        }
+
+        // HALFMOVE CLOCK AND FULLMOVE NUMBER
+        int counters[2] = {0, 1};
+        for (int& counter : counters) {
+            while (*p == ' ') {
+                p++;
+            }
+            if (*p >= '0' && *p <= '9') {
+                counter = 0;
+                while (*p >= '0' && *p <= '9') {
+                    counter = counter * 10 + (*p++ - '0');
+                }
+            }
+        }
+
+        // THE SIDE NOT TO MOVE CAN'T BE IN CHECK: ITS KING WOULD BE CAPTURED
+        if (position.attackersTo(position.kingSquare(~side), position.pieces()) & position.pieces(side)) {
+            return false;
+        }
+
+        setPosition(position, side, rights, ep, counters[0], counters[1]);
+        return true;
+    }
+
+    // REPLACES THE GAME WITH THE GIVEN POSITION, AS loadFEN DOES ONCE THE FEN IS PARSED. THE TABLEBASE GENERATOR
+    // SETS UP EVERY POSITION OF A TABLE THIS WAY
+    void setPosition(const Position& position, Color side, int rights = 0, Square ep = SQ_NONE, int halfMoves = 0, int fullMoves = 1) {
+        recyclePieces();
+        chessboard = position;
+        std::fill(pieceAt, pieceAt + SQUARE_NB, nullptr);
+        for (int i = 0; i < 8; i++) {
+            for (int j = 0; j < 8; j++) {
+                Square s = makeSquare(i, j);
+                PieceCode pc = chessboard.pieceOn(s);
+                if (pc == NO_PIECE) {
+                    continue;
+                }
+
+                std::shared_ptr<Piece> piece;
+                if (sparePieces[pc].empty()) {
+                    piece = createPiece(pc, i, j);
+                } else {
+                    piece = std::move(sparePieces[pc].back());
+                    sparePieces[pc].pop_back();
+                    piece->setRow(i);
+                    piece->setCol(j);
+                }
+
+                std::vector<std::shared_ptr<Piece>>& list = colorOf(pc) == WHITE ? whitePieces : blackPieces;
+                pieceAt[s] = piece.get();
+                listIndex[s] = int(list.size());
+                list.push_back(std::move(piece));
+            }
+        }
+
+        sideToMove = side;
+        castlingRights = rights;
+        epSquare = ep;
+        rule50 = halfMoves;
+        gamePly = 2 * std::max(fullMoves - 1, 0) + (side == BLACK ? 1 : 0);
+
+        stateStack.clear();
+        stateStack.reserve(1024);
+        movesLog.clear();
+        capturedPieces.reserve(32);
+        promotedPawns.reserve(16);
+
+        attackMap.build(chessboard);
+        key = computeKey();
+        computeScores(scoreMg, scoreEg, phase);
+    }
+
+    // WRITES THE POSITION AS FEN INTO A BUFFER OF AT LEAST 100 BYTES AND RETURNS ITS LENGTH
+    int toFEN(char* out) const {
+        char* p = out;
+
+        for (int i = 0; i < 8; i++) {
+            int empty = 0;
+            for (int j = 0; j < 8; j++) {
+                PieceCode pc = chessboard.pieceOn(makeSquare(i, j));
+                if (pc == NO_PIECE) {
+                    empty++;
+                    continue;
+                }
+                if (empty) {
+                    *p++ = char('0' + empty);
+                    empty = 0;
+                }
+                char c = " PNBRQK"[typeOf(pc)];
+                *p++ = colorOf(pc) == WHITE ? c : char(tolower(c));
+            }
+            if (empty) {
+                *p++ = char('0' + empty);
+            }
+            if (i < 7) {
+                *p++ = '/';
+            }
+        }
+
+        *p++ = ' ';
+        *p++ = sideToMove == WHITE ? 'w' : 'b';
+
+        *p++ = ' ';
+        if (!castlingRights) {
+            *p++ = '-';
+        }
+        if (castlingRights & WHITE_OO) {
+            *p++ = 'K';
+        }
+        if (castlingRights & WHITE_OOO) {
+            *p++ = 'Q';
+        }
+        if (castlingRights & BLACK_OO) {
+            *p++ = 'k';
+        }
+        if (castlingRights & BLACK_OOO) {
+            *p++ = 'q';
+        }
+
+        *p++ = ' ';
+        if (epSquare == SQ_NONE) {
+            *p++ = '-';
+        } else {
+            *p++ = char('a' + colOf(epSquare));
+            *p++ = char('1' + (epSquare >> 3));
+        }
+
+        int counters[2] = {rule50, gamePly / 2 + 1};
+        for (int counter : counters) {
+            char digits[12];
+            int n = 0;
+            do {
+                digits[n++] = char('0' + counter % 10);
+                counter /= 10;
+            } while (counter);
+            *p++ = ' ';
+            while (n) {
+                *p++ = digits[--n];
+            }
+        }
+
+        *p = '\0';
+        return int(p - out);
+    }
+
+    std::string toFEN() const {
+        char buffer[128];
+        toFEN(buffer);
+        return buffer;
+    }
+
+    bool isWhiteToMove() const {
+        return sideToMove == WHITE;
+    }
+
+    int getCastlingRights() const {
+        return castlingRights;
+    }
+
+    uint64_t getKey() const {
+        return key;
+    }
+
+    // TAPERED PIECE-SQUARE EVALUATION FROM THE SIDE TO MOVE'S POINT OF VIEW. THE SCORES ARE KEPT INCREMENTALLY, SO
+    // THIS ONLY BLENDS THEM; A PROMOTION CAN PUSH THE PHASE PAST PHASE_MAX, SO IT IS CAPPED
+    int evaluate() const {
+        int ph = std::min(phase, PHASE_MAX);
+        int score = (scoreMg * ph + scoreEg * (PHASE_MAX - ph)) / PHASE_MAX;
+        return sideToMove == WHITE ? score : -score;
+    }
+
+    // THE NETWORK'S SCORE FROM THE SIDE TO MOVE'S POINT OF VIEW. accumulators[n] BELONGS TO THE POSITION AFTER THE
+    // FIRST n MOVES ON THE STATE STACK. EACH SIDE'S ACCUMULATOR IS BROUGHT UP TO DATE FROM THE NEAREST EARLIER ONE
+    // STILL VALID FOR THIS LINE, ONE MOVE AT A TIME, SO EVERY POSITION ON THE WAY IS READY FOR THE NEXT SIBLING;
+    // TAKING A MOVE BACK NEEDS NO WORK AT ALL. ONLY A MOVE OF THAT SIDE'S OWN KING FORCES A REBUILD FROM THE BOARD
+    int evaluateNNUE() {
+        int n = int(stateStack.size());
+        if (int(accumulators.size()) <= n) {
+            accumulators.resize(std::max(2 * accumulators.size(), size_t(n + 1)));
+        }
+
+        for (Color c : {WHITE, BLACK}) {
+            int m = n;
+            bool rebuild = false;
+            while (accumulators[m].key[c] != keyAt(m)) {
+                if (m == 0 || movedKing(stateStack[m - 1].dirty, c)) {
+                    rebuild = true;
+                    break;
+                }
+                m--;
+            }
+
+            if (rebuild) {
+                refreshAccumulator(accumulators[n], c);
+            } else {
+                Square ksq = chessboard.kingSquare(c);
+                for (int i = m + 1; i <= n; i++) {
+                    updateAccumulator(accumulators[i - 1], accumulators[i], stateStack[i - 1].dirty, c, ksq);
+                    accumulators[i].key[c] = keyAt(i);
+                }
+            }
+            accumulators[n].key[c] = key;
+        }
+
+        const Accumulator& acc = accumulators[n];
+        int32_t sum = nnueKernels.output(acc.values[sideToMove], acc.values[~sideToMove], network.outputWeights.data(), network.hidden);
+        return (sum + network.outputBias) / network.outputScale;
+    }
+
+    // THE KEY makeMove WILL PRODUCE FOR A LEGAL MOVE, WITHOUT PLAYING IT, SO THE SEARCH CAN PREFETCH ITS TABLE ENTRY
+    uint64_t keyAfter(Move move) const {
+        Square from = move.from();
+        Square to = move.to();
+        PieceCode pc = chessboard.pieceOn(from);
+        uint64_t k = key ^ zobristSide;
+
+        if (epSquare != SQ_NONE) {
+            k ^= zobristEnPassant[colOf(epSquare)];
+        }
+
+        if (move.type() == CASTLING) {
+            bool kingside = colOf(to) == 6;
+            PieceCode rook = makePiece(sideToMove, ROOK);
+            k ^= zobristPiece[rook][from + (kingside ? 3 : -4)] ^ zobristPiece[rook][from + (kingside ? 1 : -1)];
+        } else {
+            Square captureSquare = move.type() == EN_PASSANT ? Square((from & ~7) | (to & 7)) : to;
+            if (!chessboard.isEmpty(captureSquare)) {
+                k ^= zobristPiece[chessboard.pieceOn(captureSquare)][captureSquare];
+            }
+
+            Square skipped = Square((from + to) / 2);
+            if (typeOf(pc) == PAWN && (to - from == 16 || from - to == 16)
+                && (pawnAttacks[sideToMove][skipped] & chessboard.pieces(~sideToMove, PAWN))) {
+                k ^= zobristEnPassant[colOf(skipped)];
+            }
+        }
+
+        PieceCode landing = move.type() == PROMOTION ? makePiece(sideToMove, move.promotionType()) : pc;
+        k ^= zobristPiece[pc][from] ^ zobristPiece[landing][to];
+        k ^= zobristCastling[castlingRights] ^ zobristCastling[castlingRights & ~(castlingRightsMask[from] | castlingRightsMask[to])];
+        return k;
+    }
+
+    // HOW MANY TIMES THE CURRENT POSITION HAS OCCURRED, COUNTING THIS ONE. ONLY POSITIONS WITH THE SAME SIDE TO MOVE
+    // SINCE THE LAST CAPTURE OR PAWN MOVE CAN MATCH, SO THE SCAN STEPS BACK TWO PLIES AT A TIME WITHIN rule50
+    int repetitionCount() const {
+        int count = 1;
+        int end = std::min(rule50, int(stateStack.size()));
+        for (int i = 2; i <= end; i += 2) {
+            if (stateStack[stateStack.size() - i].key == key) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    // THREEFOLD REPETITION OR FIFTY MOVES WITHOUT A CAPTURE OR PAWN MOVE. THE SEARCH ALREADY SCORES THE FIRST
+    // REPETITION AS A DRAW, SO IT PASSES 2
+    bool isDraw(int repetitions = 3) const {
+        return rule50 >= 100 || repetitionCount() >= repetitions;
+    }
+
+    // STATIC EXCHANGE EVALUATION: WHAT THE MOVE WINS IN MATERIAL IF BOTH SIDES THEN KEEP RECAPTURING ON ITS
+    // DESTINATION WITH THEIR LEAST VALUABLE PIECE, EACH FREE TO STOP WHEN RECAPTURING WOULD LOSE. SLIDERS BEHIND
+    // A CAPTURER JOIN IN AS IT LEAVES; PINS ARE IGNORED
+    int see(Move move) const {
+        if (move.type() == CASTLING) {
+            return 0;
+        }
+        Square from = move.from();
+        Square to = move.to();
+        Bitboard occupied = chessboard.pieces() ^ squareBB(from);
+        int gain[32];
+
+        // gain[d] IS WHAT THE SIDE MAKING CAPTURE d HAS WON SO FAR, IF THE EXCHANGE STOPPED RIGHT AFTER IT
+        PieceType onSquare = typeOf(chessboard.pieceOn(from));
+        gain[0] = chessboard.isEmpty(to) ? 0 : pieceValue[typeOf(chessboard.pieceOn(to))];
+        if (move.type() == EN_PASSANT) {
+            occupied ^= squareBB(Square((from & ~7) | (to & 7)));
+            gain[0] = pieceValue[PAWN];
+        } else if (move.type() == PROMOTION) {
+            onSquare = move.promotionType();
+            gain[0] += pieceValue[onSquare] - pieceValue[PAWN];
+        }
+
+        Bitboard bishops = chessboard.pieces(BISHOP) | chessboard.pieces(QUEEN);
+        Bitboard rooks = chessboard.pieces(ROOK) | chessboard.pieces(QUEEN);
+        Bitboard attackers = chessboard.attackersTo(to, occupied) & occupied;
+        Color side = ~sideToMove;
+        int d = 0;
+
+        while (true) {
+            Bitboard ours = attackers & chessboard.pieces(side);
+            if (!ours) {
+                break;
+            }
+            PieceType pt = PAWN;
+            while (!(ours & chessboard.pieces(pt))) {
+                pt = PieceType(pt + 1);
+            }
+            // THE KING MAY ONLY TAKE IF NOTHING CAN TAKE IT BACK
+            if (pt == KING && (attackers & chessboard.pieces(~side))) {
+                break;
+            }
+
+            d++;
+            gain[d] = pieceValue[onSquare] - gain[d - 1];
+            onSquare = pt;
+            occupied ^= squareBB(lsb(ours & chessboard.pieces(pt)));
+            attackers |= (bishopAttacks(to, occupied) & bishops) | (rookAttacks(to, occupied) & rooks);
+            attackers &= occupied;
+            side = ~side;
+        }
+
+        // WORK BACK FROM THE END: EACH SIDE ONLY MAKES ITS CAPTURE IF THAT BEATS STOPPING
+        while (d > 0) {
+            gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+            d--;
+        }
+        return gain[0];
+    }
+
+    bool inCheck() const {
+        return attackMap.attacks(~sideToMove) & chessboard.pieces(sideToMove, KING);
+    }
+
+    const Position& getPosition() const {
+        return chessboard;
+    }
+
+    // COUNTS THE LEAF NODES OF THE MOVE TREE TO A FIXED DEPTH; THE LAST PLY IS COUNTED WITHOUT BEING PLAYED
+    uint64_t perft(int depth) {
+        MoveList moveList;
+        generateMoves(sideToMove == WHITE, moveList);
+        if (depth <= 1) {
+            return depth == 1 ? moveList.size() : 1;
+        }
+
+        uint64_t nodes = 0;
+        for (Move move : moveList) {
+            makeMove(move);
+            nodes += perft(depth - 1);
+            unmakeMove(move);
+        }
+        return nodes;
+    }
+
+    // PERFT SPLIT BY ROOT MOVE, FOR HUNTING DOWN A WRONG COUNT AGAINST ANOTHER ENGINE
+    uint64_t divide(int depth) {
+        MoveList moveList;
+        generateMoves(sideToMove == WHITE, moveList);
+
+        uint64_t nodes = 0;
+        for (Move move : moveList) {
+            makeMove(move);
+            uint64_t count = perft(depth - 1);
+            unmakeMove(move);
+            std::cout << moveToUCI(move) << ": " << count << std::endl;
+            nodes += count;
+        }
+        return nodes;
+    }
+
+    // DISPLAY CHESSBOARD
+    void displayBoard() {
+        for (int i = 0; i < 8; i++) {
+            for (int j = 0; j < 8; j++) {
+                // FORMATS OUTPUT IN A TABULAR MANNER
+                std::cout << std::setw(3) << chessboard.pieceID(makeSquare(i, j));
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    // METHOD TO PRINT POSITIONS OF CHESS PIECES
+    void printPiecePositions() {
+        // OF WHITE COLOUR:
+        std::cout << "White's Chess Piece Positions:" << std::endl;
+        for (const auto& piece : whitePieces) {
+            std::cout << piece->getType() << "(" << piece->getRowIndex() << ", " << piece->getColIndex() << "), ";
+        }
+        std::cout << std::endl;
+        std::cout << std::endl;
+        // OF BLACK COLOUR:
+        std::cout << "Black's Chess Piece Positions:" << std::endl;
+        for (const auto& piece : blackPieces) {
+            std::cout << piece->getType() << "(" << piece->getRowIndex() << ", " << piece->getColIndex() << "), ";
+        }
+        std::cout << std::endl;
+        std::cout << std::endl;
+    }
+
+    void printLegalMoves(bool whiteTurn) {
+        const MoveList& moveList = whiteTurn ? whiteLegalMoves : blackLegalMoves;
+
+        if (whiteTurn) {
+            std::cout << "Legal moves for White:" << std::endl;
+        } else {
+            std::cout << "Legal moves for Black:" << std::endl;
+        }
+
+        printMoveList(moveList);
+    }
+
+    // PRINTS THE MOVES GROUPED BY THE SQUARE OF THE PIECE MAKING THEM ("e2: e3 e4 , ...")
+    void printMoveList(const MoveList& moveList) {
+        Bitboard printed = 0;
+        for (int i = 0; i < moveList.size(); i++) {
+            Square from = moveList[i].from();
+            if (printed & squareBB(from)) {
+                continue;
+            }
+            printed |= squareBB(from);
+
+            std::cout << squareToString(from) << ": ";
+            for (int j = i; j < moveList.size(); j++) {
+                if (moveList[j].from() == from) {
+                    std::cout << moveToSAN(moveList[j], moveList) << " ";
+                }
+            }
+            std::cout << ", ";
+        }
+        std::cout << std::endl;
+    }
+
+    // Modify the generateLegalMoves function to handle all piece types
+    void generateLegalMoves(bool whiteTurn) {
+        // Clear the move lists
+        whiteLegalMoves.clear();
+        blackLegalMoves.clear();
+
+        generateMoves(whiteTurn, whiteTurn ? whiteLegalMoves : blackLegalMoves);
+    }
+
+    // GENERATES EVERY LEGAL MOVE. WITH firstOnly IT STOPS ONCE A MOVE IS KNOWN TO EXIST
+    void generateMoves(bool whiteTurn, MoveList& moveList, bool firstOnly = false) const {
+        generate<ALL_MOVES>(whiteTurn ? WHITE : BLACK, moveList, ~Bitboard(0), firstOnly);
+    }
+
+    // GENERATES THE LEGAL CAPTURES, QUIET MOVES OR BOTH OF THE SIDE TO MOVE
+    template<GenType Type>
+    void generateMoves(MoveList& moveList) const {
+        generate<Type>(sideToMove, moveList, ~Bitboard(0), false);
+    }
+
+    // TRUE IF THE MOVE IS LEGAL HERE. FOR MOVES THAT DIDN'T COME FROM THIS POSITION'S OWN LIST, SUCH AS A STORED
+    // HASH MOVE OR KILLER; ONLY THE MOVES ONTO ITS DESTINATION SQUARE ARE GENERATED TO CHECK IT
+    bool isLegal(Move move) const {
+        if (move == MOVE_NONE || chessboard.isEmpty(move.from()) || colorOf(chessboard.pieceOn(move.from())) != sideToMove) {
+            return false;
+        }
+        MoveList moveList;
+        generate<ALL_MOVES>(sideToMove, moveList, squareBB(move.to()), false);
+        for (Move m : moveList) {
+            if (m == move) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // GENERATES ONLY LEGAL MOVES: PINNED PIECES STAY ON THEIR PIN LINE, CHECKS MUST BE CAPTURED OR BLOCKED,
+    // AND THE KING ONLY STEPS ONTO UNATTACKED SQUARES. ONLY MOVES ENDING ON destinations ARE GENERATED
+    template<GenType Type>
+    void generate(Color us, MoveList& moveList, Bitboard destinations, bool firstOnly) const {
+        Color them = ~us;
+        Square ksq = chessboard.kingSquare(us);
+        Bitboard occupied = chessboard.pieces();
+        Bitboard checkers = chessboard.attackersTo(ksq, occupied) & chessboard.pieces(them);
+        Bitboard pinned = sliderBlockers(ksq, them) & chessboard.pieces(us);
+
+        // King steps must avoid every attacked square, and also the squares behind the king on a checking slider's ray,
+        // which the attack map sees as shadowed by the king itself
+        Bitboard safe = kingAttacks[ksq] & ~chessboard.pieces(us) & ~attackMap.attacks(them) & destinations;
+        if (Type == CAPTURES) {
+            safe &= chessboard.pieces(them);
+        } else if (Type == QUIETS) {
+            safe &= ~occupied;
+        }
+        for (Bitboard b = checkers & ~chessboard.pieces(PAWN) & ~chessboard.pieces(KNIGHT); b; ) {
+            Square s = popLsb(b);
+            safe &= ~(lineBB[ksq][s] ^ squareBB(s));
+        }
+
+        // A king move is usually the cheapest way to prove that a legal move exists
+        if (firstOnly && safe) {
+            moveList.add(Move(ksq, lsb(safe)));
+            return;
+        }
+
+        // IN CHECK THE OTHER PIECES MUST CAPTURE THE CHECKER OR BLOCK IT; IN DOUBLE CHECK ONLY THE KING MAY MOVE
+        Bitboard target = ~chessboard.pieces(us) & destinations;
+        if (popcount(checkers) > 1) {
+            target = 0;
+        } else if (checkers) {
+            target &= betweenBB[ksq][lsb(checkers)] | checkers;
+        }
+
+        // PAWNS THAT MAY CAPTURE EN PASSANT; AT MOST TWO, EACH CHECKED ON THE BOARD AFTER THE CAPTURE
+        Bitboard epCapturers = 0;
+        if (epSquare != SQ_NONE && (destinations & squareBB(epSquare))) {
+            for (Bitboard b = pawnAttacks[them][epSquare] & chessboard.pieces(us, PAWN); b; ) {
+                Square from = popLsb(b);
+                if (legalEpSquare(us, from) != SQ_NONE) {
+                    epCapturers |= squareBB(from);
+                }
+            }
+        }
+
+        if (us == WHITE) {
+            generatePieceMoves<WHITE, Type>(moveList, chessboard, target, pinned, ksq, epCapturers, epSquare);
+        } else {
+            generatePieceMoves<BLACK, Type>(moveList, chessboard, target, pinned, ksq, epCapturers, epSquare);
+        }
+        addPieceMoves(moveList, ksq, safe);
+
+        if (firstOnly && !moveList.empty()) {
+            return;
+        }
+
+        if (Type != CAPTURES && !checkers) {
+            generateCastling(us, moveList, destinations);
+        }
+    }
+
+    // CASTLING NEEDS THE RIGHT, AN EMPTY PATH BETWEEN KING AND ROOK, AND NO ATTACK ON THE SQUARES THE KING CROSSES.
+    // THE CALLER HAS ALREADY MADE SURE THE KING IS NOT IN CHECK; NOTHING HERE DEPENDS ON THE MOVES PLAYED SO FAR
+    void generateCastling(Color us, MoveList& moveList, Bitboard destinations) const {
+        Bitboard attacked = attackMap.attacks(~us);
+
+        for (const CastlingPath& c : castlingPaths[us]) {
+            if ((castlingRights & c.right) && (destinations & squareBB(c.kingTo)) && !(chessboard.pieces() & c.empty) && !(attacked & c.kingPath)) {
+                moveList.add(Move(c.kingFrom, c.kingTo, CASTLING));
+            }
+        }
+    }
+
+    // TRUE IF THE SIDE TO MOVE HAS AT LEAST ONE LEGAL MOVE
+    bool hasLegalMove() const {
+        MoveList moveList;
+        generateMoves(sideToMove == WHITE, moveList, true);
+        return !moveList.empty();
+    }
+
+    // TRUE IF THE MOVE CHECKS THE OPPONENT'S KING, EITHER WITH THE MOVED PIECE OR BY UNCOVERING ONE OF OUR SLIDERS
+    bool givesCheck(Move move) const {
+        Square from = move.from();
+        Square to = move.to();
+        Color us = sideToMove;
+        Square ksq = chessboard.kingSquare(us == WHITE ? BLACK : WHITE);
+        Bitboard occupied = (chessboard.pieces() ^ squareBB(from)) | squareBB(to);
+
+        if (move.type() == CASTLING) {
+            // ONLY THE ROOK CAN GIVE CHECK AFTER CASTLING
+            bool kingside = colOf(to) == 6;
+            Square rookFrom = Square(kingside ? from + 3 : from - 4);
+            Square rookTo = Square(kingside ? from + 1 : from - 1);
+            occupied = (occupied ^ squareBB(rookFrom)) | squareBB(rookTo);
+            return rookAttacks(rookTo, occupied) & squareBB(ksq);
+        }
+
+        if (move.type() == EN_PASSANT) {
+            occupied ^= squareBB(Square(to + (us == WHITE ? -8 : 8)));
+        }
+
+        PieceType pt = move.type() == PROMOTION ? move.promotionType() : typeOf(chessboard.pieceOn(from));
+        if (pieceAttacks(pt, us, to, occupied) & squareBB(ksq)) {
+            return true;
+        }
+
+        Bitboard sliders = (bishopAttacks(ksq, occupied) & (chessboard.pieces(us, BISHOP) | chessboard.pieces(us, QUEEN)))
+                         | (rookAttacks(ksq, occupied) & (chessboard.pieces(us, ROOK) | chessboard.pieces(us, QUEEN)));
+        return sliders & ~squareBB(from);
+    }
+
+    // PLAYS A MOVE IN PLACE, PUSHING WHAT IS NEEDED TO TAKE IT BACK ONTO THE STATE STACK
+    void makeMove(Move move) {
+        Square from = move.from();
+        Square to = move.to();
+        Color us = sideToMove;
+        PieceCode moving = chessboard.pieceOn(from);
+        Bitboard changed = changedSquares(move);
+        Bitboard sliders = attackMap.lift(chessboard, changed);
+
+        StateInfo st;
+        st.captured = NO_PIECE;
+        st.castlingRights = castlingRights;
+        st.epSquare = epSquare;
+        st.rule50 = rule50;
+        st.key = key;
+        st.dirty.count = 0;
+
+        if (epSquare != SQ_NONE) {
+            key ^= zobristEnPassant[colOf(epSquare)];
+        }
+        key ^= zobristCastling[castlingRights];
+        epSquare = SQ_NONE;
+        rule50++;
+
+        if (move.type() == CASTLING) {
+            // THE ROOK JUMPS FROM ITS CORNER TO THE SQUARE THE KING PASSED OVER
+            bool kingside = colOf(to) == 6;
+            movePiece(from, to);
+            movePiece(Square(from + (kingside ? 3 : -4)), Square(from + (kingside ? 1 : -1)));
+            st.dirty.add(moving, from, to);
+            st.dirty.add(makePiece(us, ROOK), Square(from + (kingside ? 3 : -4)), Square(from + (kingside ? 1 : -1)));
+        } else {
+            // THE CAPTURED PAWN OF AN EN PASSANT CAPTURE IS BEHIND THE DESTINATION SQUARE
+            Square captureSquare = move.type() == EN_PASSANT ? Square(to + (us == WHITE ? -8 : 8)) : to;
+
+            if (!chessboard.isEmpty(captureSquare)) {
+                st.captured = chessboard.pieceOn(captureSquare);
+                st.dirty.add(st.captured, captureSquare, SQ_NONE);
+                capturedPieces.push_back(takePiece(captureSquare));
+                rule50 = 0;
+            }
+
+            movePiece(from, to);
+
+            if (typeOf(moving) == PAWN) {
+                rule50 = 0;
+                // A DOUBLE PUSH MAKES THE SKIPPED SQUARE CAPTURABLE EN PASSANT, IF AN ENEMY PAWN IS THERE TO DO IT;
+                // OTHERWISE THE SQUARE WOULD MAKE IDENTICAL POSITIONS HASH DIFFERENTLY
+                Square skipped = Square((from + to) / 2);
+                if ((to - from == 16 || from - to == 16) && (pawnAttacks[us][skipped] & chessboard.pieces(us == WHITE ? BLACK : WHITE, PAWN))) {
+                    epSquare = skipped;
+                    key ^= zobristEnPassant[colOf(epSquare)];
+                }
+            }
+
+            if (move.type() == PROMOTION) {
+                // THE PAWN WAITS ON ITS OWN STACK; THE NEW PIECE IS REUSED FROM AN EARLIER TAKEN-BACK PROMOTION IF THERE IS ONE
+                PieceCode promoted = makePiece(us, move.promotionType());
+                promotedPawns.push_back(takePiece(to));
+                std::shared_ptr<Piece> piece;
+                if (sparePieces[promoted].empty()) {
+                    piece = createPiece(promoted, rowOf(to), colOf(to));
+                } else {
+                    piece = std::move(sparePieces[promoted].back());
+                    sparePieces[promoted].pop_back();
+                    piece->setRow(rowOf(to));
+                    piece->setCol(colOf(to));
+                }
+                placePiece(std::move(piece), promoted, to);
+                st.dirty.add(moving, from, SQ_NONE);
+                st.dirty.add(promoted, SQ_NONE, to);
+            } else {
+                st.dirty.add(moving, from, to);
+            }
+        }
+
+        // ANY MOVE FROM OR TO A KING OR ROOK HOME SQUARE CLEARS THE RIGHTS THAT DEPEND ON IT
+        castlingRights &= ~(castlingRightsMask[from] | castlingRightsMask[to]);
+
+        key ^= zobristCastling[castlingRights] ^ zobristSide;
+
+        attackMap.drop(chessboard, changed, sliders);
+        stateStack.push_back(st);
+        sideToMove = us == WHITE ? BLACK : WHITE;
+        gamePly++;
+        verifyKey("makeMove");
+    }
+
+    // TAKES BACK THE LAST MOVE PLAYED WITH makeMove
+    void unmakeMove(Move move) {
+        Square from = move.from();
+        Square to = move.to();
+        sideToMove = sideToMove == WHITE ? BLACK : WHITE;
+        gamePly--;
+        Color us = sideToMove;
+        Bitboard changed = changedSquares(move);
+        Bitboard sliders = attackMap.lift(chessboard, changed);
+
+        const StateInfo& st = stateStack.back();
+
+        if (move.type() == CASTLING) {
+            bool kingside = colOf(to) == 6;
+            movePiece(Square(from + (kingside ? 1 : -1)), Square(from + (kingside ? 3 : -4)));
+            movePiece(to, from);
+        } else {
+            if (move.type() == PROMOTION) {
+                // TURN THE PROMOTED PIECE BACK INTO A PAWN
+                PieceCode promoted = chessboard.pieceOn(to);
+                sparePieces[promoted].push_back(takePiece(to));
+                placePiece(std::move(promotedPawns.back()), makePiece(us, PAWN), to);
+                promotedPawns.pop_back();
+            }
+
+            movePiece(to, from);
+
+            if (st.captured != NO_PIECE) {
+                Square captureSquare = move.type() == EN_PASSANT ? Square(to + (us == WHITE ? -8 : 8)) : to;
+                placePiece(std::move(capturedPieces.back()), st.captured, captureSquare);
+                capturedPieces.pop_back();
+            }
+        }
+
+        castlingRights = st.castlingRights;
+        epSquare = st.epSquare;
+        rule50 = st.rule50;
+        // THE PIECE MOVES ABOVE ALREADY UNDID THEIR PART OF THE KEY, BUT THE SAVED KEY ALSO COVERS THE REST
+        key = st.key;
+        stateStack.pop_back();
+        attackMap.drop(chessboard, changed, sliders);
+        verifyKey("unmakeMove");
+    }
+
+    // PASSES THE TURN WITHOUT MOVING, FOR THE SEARCH'S NULL-MOVE PRUNING; NEVER CALLED IN CHECK. THE FIFTY-MOVE COUNT
+    // STARTS AGAIN, SO NO REPETITION IS FOUND ACROSS THE NULL MOVE
+    void makeNullMove() {
+        StateInfo st;
+        st.captured = NO_PIECE;
+        st.castlingRights = castlingRights;
+        st.epSquare = epSquare;
+        st.rule50 = rule50;
+        st.key = key;
+        st.dirty.count = 0;
+
+        if (epSquare != SQ_NONE) {
+            key ^= zobristEnPassant[colOf(epSquare)];
+            epSquare = SQ_NONE;
+        }
+        key ^= zobristSide;
+        rule50 = 0;
+
+        stateStack.push_back(st);
+        sideToMove = ~sideToMove;
+        gamePly++;
+        verifyKey("makeNullMove");
+    }
+
+    void unmakeNullMove() {
+        sideToMove = ~sideToMove;
+        gamePly--;
+        const StateInfo& st = stateStack.back();
+        epSquare = st.epSquare;
+        rule50 = st.rule50;
+        key = st.key;
+        stateStack.pop_back();
+        verifyKey("unmakeNullMove");
+    }
+
+    // SAN FORMATTING. NOTHING HERE RUNS DURING MOVE GENERATION, PERFT OR makeMove; STRINGS ARE ONLY BUILT FOR
+    // MOVES THAT ARE SHOWN TO OR READ FROM THE USER
+
+    // SAN OF ONE MOVE WITHOUT THE CHECK SUFFIX. moveList IS THE LEGAL MOVE LIST, ONLY SCANNED FOR DISAMBIGUATION
+    std::string sanBody(Move move, const MoveList& moveList) const {
+        Square from = move.from();
+        Square to = move.to();
+        std::string san;
+
+        if (move.type() == CASTLING) {
+            san = colOf(to) == 6 ? "O-O" : "O-O-O";
+        } else {
+            PieceType pt = typeOf(chessboard.pieceOn(from));
+            bool capture = !chessboard.isEmpty(to) || move.type() == EN_PASSANT;
+
+            if (pt == PAWN) {
+                if (capture) {
+                    san += char('a' + colOf(from));
+                }
+            } else {
+                san += " PNBRQK"[pt];
+
+                // ADD THE FILE, RANK OR BOTH WHEN ANOTHER PIECE OF THE SAME TYPE CAN REACH THE SAME SQUARE
+                bool ambiguous = false, sameFile = false, sameRank = false;
+                for (Move other : moveList) {
+                    if (other.to() == to && other.from() != from && chessboard.pieceOn(other.from()) == chessboard.pieceOn(from)) {
+                        ambiguous = true;
+                        sameFile = sameFile || colOf(other.from()) == colOf(from);
+                        sameRank = sameRank || rowOf(other.from()) == rowOf(from);
+                    }
+                }
+                if (ambiguous) {
+                    if (!sameFile) {
+                        san += char('a' + colOf(from));
+                    } else if (!sameRank) {
+                        san += char('1' + (from >> 3));
+                    } else {
+                        san += squareToString(from);
+                    }
+                }
+            }
+
+            if (capture) {
+                san += 'x';
+            }
+            san += squareToString(to);
+
+            if (move.type() == PROMOTION) {
+                san += '=';
+                san += " PNBRQK"[move.promotionType()];
+            }
+        }
+
+        return san;
+    }
+
+    // FULLY DECORATED SAN; THE "+" OR "#" IS WORKED OUT FOR THIS MOVE ALONE, AND THE REPLIES ARE ONLY
+    // SEARCHED WHEN THE MOVE GIVES CHECK
+    std::string moveToSAN(Move move, const MoveList& moveList) {
+        std::string san = sanBody(move, moveList);
+        if (givesCheck(move)) {
+            makeMove(move);
+            san += hasLegalMove() ? '+' : '#';
+            unmakeMove(move);
+        }
+        return san;
+    }
+
+    // THE SAME FOR A SINGLE MOVE WHEN THE CALLER HAS NO LEGAL MOVE LIST AT HAND
+    std::string moveToSAN(Move move) {
+        MoveList moveList;
+        generateMoves(sideToMove == WHITE, moveList);
+        return moveToSAN(move, moveList);
+    }
+
+    // FINDS THE LEGAL MOVE WHOSE SAN MATCHES THE USER'S INPUT. A TRAILING "+" OR "#" IS OPTIONAL, SO NO
+    // CHECK SUFFIXES HAVE TO BE WORKED OUT TO MATCH IT
+    Move findMove(const std::string& userInput, bool whiteTurn) const {
+        const MoveList& moveList = whiteTurn ? whiteLegalMoves : blackLegalMoves;
+        std::string body = userInput;
+        while (!body.empty() && (body.back() == '+' || body.back() == '#')) {
+            body.pop_back();
+        }
+
+        for (Move move : moveList) {
+            if (body == sanBody(move, moveList)) {
+                return move;
+            }
+        }
+        return MOVE_NONE;
+    }
+
+    // PLAYS A LEGAL MOVE ON THE REAL BOARD
+    void playMove(Move move) {
+        makeMove(move);
+    }
+
+    // ADDS A MOVE TO THE GAME RECORD
+    void logMove(const std::string& san) {
+        movesLog.push_back(san);
+    }
+
+    const std::vector<std::string>& getMovesLog() const {
+        return movesLog;
+    }
+
+    const MoveList& getWhiteLegalMoves() const {
+        return whiteLegalMoves;
+    }
+
+    const MoveList& getBlackLegalMoves() const {
+        return blackLegalMoves;
+    }
+
+private:
+
+    // THE BOARD: PIECE BITBOARDS PLUS AN 8x8 MAILBOX
+    Position chessboard;
+    // STORES ALL OF WHITE'S PIECES AS A VECTOR
+    std::vector<std::shared_ptr<Piece>> whitePieces;
+    // STORES ALL OF BLACK'S PIECES AS A VECTOR
+    std::vector<std::shared_ptr<Piece>> blackPieces;
+
+    // SIDE TO MOVE, CASTLING RIGHTS, EN PASSANT SQUARE AND HALFMOVE CLOCK OF THE CURRENT POSITION
+    Color sideToMove;
+    int castlingRights;
+    Square epSquare;
+    int rule50;
+    // ZOBRIST KEY OF THE CURRENT POSITION
+    uint64_t key;
+    // MIDDLEGAME AND ENDGAME PIECE-SQUARE SCORES FROM WHITE'S POINT OF VIEW, AND THE GAME PHASE (PHASE_MAX WITH ALL
+    // PIECES ON THE BOARD), KEPT UP TO DATE BY movePiece, takePiece AND placePiece
+    int scoreMg;
+    int scoreEg;
+    int phase;
+    // THE ATTACK MAP OF THE POSITION ON THE BOARD
+    AttackMap attackMap;
+    // SAN OF EVERY MOVE PLAYED IN THE GAME
+    std::vector<std::string> movesLog;
+    // HALF-MOVES SINCE THE START OF THE GAME, FOR THE FULLMOVE NUMBER
+    int gamePly;
+
+    // ONE ENTRY PER MOVE PLAYED WITH makeMove
+    std::vector<StateInfo> stateStack;
+    // NETWORK ACCUMULATORS, ONE PER POSITION ON THE STATE STACK PLUS THE CURRENT ONE; FILLED ONLY BY evaluateNNUE
+    std::vector<Accumulator> accumulators;
+    // PIECE OBJECTS REMOVED BY CAPTURES, RESTORED BY unmakeMove
+    std::vector<std::shared_ptr<Piece>> capturedPieces;
+    // PAWNS REPLACED BY A PROMOTION, AND PROMOTED PIECES TAKEN BACK BY unmakeMove (KEPT FOR THE NEXT PROMOTION)
+    std::vector<std::shared_ptr<Piece>> promotedPawns;
+    std::vector<std::shared_ptr<Piece>> sparePieces[PIECE_CODE_NB];
+
+    // THE PIECE OBJECT ON EACH SQUARE, AND ITS PLACE IN whitePieces OR blackPieces
+    Piece* pieceAt[SQUARE_NB];
+    int listIndex[SQUARE_NB];
+
+    // LEGAL MOVES FOR WHITE AND BLACK
+    MoveList whiteLegalMoves;
+    MoveList blackLegalMoves;
+
+    // A NEW PIECE OBJECT FOR A PIECE ON THE BOARD, REGISTERED IN pieceAt; THE CALLER PUTS IT IN ITS LIST
+    std::shared_ptr<Piece> copyPiece(const Piece& piece) {
+        Square s = makeSquare(piece.getRowIndex(), piece.getColIndex());
+        std::shared_ptr<Piece> copy = createPiece(chessboard.pieceOn(s), rowOf(s), colOf(s));
+        pieceAt[s] = copy.get();
+        return copy;
+    }
+
+    // MOVES EVERY PIECE OBJECT, ON THE BOARD OR WAITING ON A TAKEBACK STACK, INTO sparePieces FOR THE NEXT SET-UP
+    void recyclePieces() {
+        for (std::vector<std::shared_ptr<Piece>>* list : {&whitePieces, &blackPieces}) {
+            for (std::shared_ptr<Piece>& piece : *list) {
+                PieceCode pc = chessboard.pieceOn(makeSquare(piece->getRowIndex(), piece->getColIndex()));
+                sparePieces[pc].push_back(std::move(piece));
+            }
+            list->clear();
+        }
+
+        // CAPTURED PIECES WERE PUSHED IN THE SAME ORDER AS THE CAPTURES ON THE STATE STACK
+        int next = 0;
+        for (const StateInfo& st : stateStack) {
+            if (st.captured != NO_PIECE) {
+                sparePieces[st.captured].push_back(std::move(capturedPieces[next++]));
+            }
+        }
+        capturedPieces.clear();
+
+        for (std::shared_ptr<Piece>& pawn : promotedPawns) {
+            sparePieces[pawn->getColor() == "White" ? W_PAWN : B_PAWN].push_back(std::move(pawn));
+        }
+        promotedPawns.clear();
+    }
+
+    // MOVES A PIECE TO AN EMPTY SQUARE
+    void movePiece(Square from, Square to) {
+        pieceAt[to] = pieceAt[from];
+        pieceAt[from] = nullptr;
+        listIndex[to] = listIndex[from];
+        pieceAt[to]->setRow(rowOf(to));
+        pieceAt[to]->setCol(colOf(to));
+        PieceCode pc = chessboard.pieceOn(from);
+        key ^= zobristPiece[pc][from] ^ zobristPiece[pc][to];
+        scoreMg += psqMg[pc][to] - psqMg[pc][from];
+        scoreEg += psqEg[pc][to] - psqEg[pc][from];
+        chessboard.movePiece(from, to);
+    }
+
+    // TAKES A PIECE OFF THE BOARD AND OUT OF ITS LIST, FILLING THE GAP WITH THE LAST PIECE OF THE LIST
+    std::shared_ptr<Piece> takePiece(Square s) {
+        std::vector<std::shared_ptr<Piece>>& list = colorOf(chessboard.pieceOn(s)) == WHITE ? whitePieces : blackPieces;
+        int index = listIndex[s];
+        std::shared_ptr<Piece> piece = std::move(list[index]);
+
+        if (index != int(list.size()) - 1) {
+            list[index] = std::move(list.back());
+            listIndex[makeSquare(list[index]->getRowIndex(), list[index]->getColIndex())] = index;
+        }
+        list.pop_back();
+
+        PieceCode pc = chessboard.pieceOn(s);
+        pieceAt[s] = nullptr;
+        key ^= zobristPiece[pc][s];
+        scoreMg -= psqMg[pc][s];
+        scoreEg -= psqEg[pc][s];
+        phase -= phaseWeight[typeOf(pc)];
+        chessboard.removePiece(s);
+        return piece;
+    }
+
+    // PUTS A PIECE OBJECT BACK ON AN EMPTY SQUARE AND AT THE END OF ITS LIST
+    void placePiece(std::shared_ptr<Piece> piece, PieceCode pc, Square s) {
+        std::vector<std::shared_ptr<Piece>>& list = colorOf(pc) == WHITE ? whitePieces : blackPieces;
+        pieceAt[s] = piece.get();
+        listIndex[s] = int(list.size());
+        list.push_back(std::move(piece));
+        key ^= zobristPiece[pc][s];
+        scoreMg += psqMg[pc][s];
+        scoreEg += psqEg[pc][s];
+        phase += phaseWeight[typeOf(pc)];
+        chessboard.putPiece(pc, s);
+    }
+
+    // ZOBRIST KEY OF THE POSITION AFTER THE FIRST n MOVES ON THE STATE STACK
+    uint64_t keyAt(int n) const {
+        return n < int(stateStack.size()) ? stateStack[n].key : key;
+    }
+
+    static bool movedKing(const DirtyPieces& dirty, Color c) {
+        return (dirty.count > 0 && dirty.piece[0] == makePiece(c, KING)) || (dirty.count > 1 && dirty.piece[1] == makePiece(c, KING));
+    }
+
+    // SIDE c'S ACCUMULATOR SUMMED FROM THE BIASES AND EVERY PIECE ON THE BOARD
+    void refreshAccumulator(Accumulator& acc, Color c) const {
+        int16_t* values = acc.values[c];
+        std::memcpy(values, network.biases.data(), network.hidden * sizeof(int16_t));
+        Square ksq = chessboard.kingSquare(c);
+        for (Bitboard b = chessboard.pieces() & ~chessboard.pieces(KING); b; ) {
+            Square s = popLsb(b);
+            nnueKernels.addRow(values, &network.weights[featureIndex(c, ksq, chessboard.pieceOn(s), s)], network.hidden);
+        }
+    }
+
+    // SIDE c'S ACCUMULATOR AFTER A MOVE THAT DID NOT MOVE c'S KING, FROM THE ONE BEFORE IT
+    static void updateAccumulator(const Accumulator& before, Accumulator& after, const DirtyPieces& dirty, Color c, Square ksq) {
+        int16_t* values = after.values[c];
+        std::memcpy(values, before.values[c], network.hidden * sizeof(int16_t));
+        for (int i = 0; i < dirty.count; i++) {
+            if (typeOf(dirty.piece[i]) == KING) {
+                continue;
+            }
+            if (dirty.from[i] != SQ_NONE) {
+                nnueKernels.subRow(values, &network.weights[featureIndex(c, ksq, dirty.piece[i], dirty.from[i])], network.hidden);
+            }
+            if (dirty.to[i] != SQ_NONE) {
+                nnueKernels.addRow(values, &network.weights[featureIndex(c, ksq, dirty.piece[i], dirty.to[i])], network.hidden);
+            }
+        }
+    }
+
+    // THE KEY OF THE CURRENT POSITION BUILT FROM SCRATCH; makeMove KEEPS key EQUAL TO THIS INCREMENTALLY
+    uint64_t computeKey() const {
+        uint64_t k = zobristCastling[castlingRights];
+        for (Bitboard b = chessboard.pieces(); b; ) {
+            Square s = popLsb(b);
+            k ^= zobristPiece[chessboard.pieceOn(s)][s];
+        }
+        if (epSquare != SQ_NONE) {
+            k ^= zobristEnPassant[colOf(epSquare)];
+        }
+        if (sideToMove == BLACK) {
+            k ^= zobristSide;
+        }
+        return k;
+    }
+
+    // THE PIECE-SQUARE SCORES AND GAME PHASE BUILT FROM SCRATCH; THE PIECE HELPERS KEEP THE MEMBERS EQUAL TO THESE
+    void computeScores(int& mg, int& eg, int& ph) const {
+        mg = eg = ph = 0;
+        for (Bitboard b = chessboard.pieces(); b; ) {
+            Square s = popLsb(b);
+            PieceCode pc = chessboard.pieceOn(s);
+            mg += psqMg[pc][s];
+            eg += psqEg[pc][s];
+            ph += phaseWeight[typeOf(pc)];
+        }
+    }
+
+    // BUILD WITH -DCHECK_HASH TO COMPARE THE INCREMENTAL KEY AND SCORES WITH RECOMPUTED ONES AFTER EVERY MOVE AND
+    // TAKEBACK
+    void verifyKey(const char* where) const {
+#if defined(CHECK_HASH)
+        if (key != computeKey()) {
+            std::cerr << "Zobrist key mismatch after " << where << std::endl;
+            std::abort();
+        }
+        int mg, eg, ph;
+        computeScores(mg, eg, ph);
+        if (mg != scoreMg || eg != scoreEg || ph != phase) {
+            std::cerr << "Piece-square score mismatch after " << where << std::endl;
+            std::abort();
+        }
+#else
+        (void)where;
+#endif
+    }
+
+    // SQUARES WHOSE CONTENTS A MOVE CHANGES: FROM AND TO, PLUS THE PAWN TAKEN EN PASSANT OR THE ROOK OF A CASTLING MOVE
+    Bitboard changedSquares(Move move) const {
+        Bitboard changed = squareBB(move.from()) | squareBB(move.to());
+        if (move.type() == EN_PASSANT) {
+            changed |= squareBB(Square((move.from() & ~7) | (move.to() & 7)));
+        } else if (move.type() == CASTLING) {
+            bool kingside = colOf(move.to()) == 6;
+            changed |= squareBB(Square(move.from() + (kingside ? 3 : -4))) | squareBB(Square(move.from() + (kingside ? 1 : -1)));
+        }
+        return changed;
+    }
+
+    // PIECES OF EITHER COLOUR THAT ARE THE ONLY THING STANDING BETWEEN A SQUARE AND A SLIDER OF THE GIVEN COLOUR
+    Bitboard sliderBlockers(Square s, Color sniperColor) const {
+        Bitboard snipers = (bishopAttacks(s, 0) & (chessboard.pieces(sniperColor, BISHOP) | chessboard.pieces(sniperColor, QUEEN)))
+                         | (rookAttacks(s, 0) & (chessboard.pieces(sniperColor, ROOK) | chessboard.pieces(sniperColor, QUEEN)));
+        Bitboard blockers = 0;
+
+        while (snipers) {
+            Bitboard between = betweenBB[s][popLsb(snipers)] & chessboard.pieces();
+            if (between && !(between & (between - 1))) {
+                blockers |= between;
+            }
+        }
+        return blockers;
+    }
+
+    // THE EN PASSANT SQUARE IF THIS PAWN MAY CAPTURE ONTO IT, OTHERWISE SQ_NONE. BOTH PAWNS LEAVE THE RANK,
+    // SO THE TEST IS DONE ON THE OCCUPANCY AFTER THE CAPTURE
+    Square legalEpSquare(Color us, Square from) const {
+        if (epSquare == SQ_NONE || !(pawnAttacks[us][from] & squareBB(epSquare))) {
+            return SQ_NONE;
+        }
+
+        Square captureSquare = Square(epSquare + (us == WHITE ? -8 : 8));
+        Bitboard occupied = (chessboard.pieces() ^ squareBB(from) ^ squareBB(captureSquare)) | squareBB(epSquare);
+        Bitboard attackers = chessboard.attackersTo(chessboard.kingSquare(us), occupied) & chessboard.pieces(us == WHITE ? BLACK : WHITE);
+
+        return (attackers & ~squareBB(captureSquare)) ? SQ_NONE : epSquare;
+    }
+};
+
+// ENDGAME TABLEBASES
+
+// A TABLE HOLDS THE EXACT RESULT OF EVERY POSITION WITH ONE MATERIAL SIGNATURE, SUCH AS "KRvK" OR "KRPvKR": WIN, DRAW
+// OR LOSS FOR THE SIDE TO MOVE, WITH THE DISTANCE TO MATE. THE STRONGER SIDE COMES FIRST AND PLAYS WHITE IN THE TABLE;
+// A POSITION WITH THE COLOURS THE OTHER WAY ROUND IS LOOKED UP MIRRORED. THE FILE "<signature>.tb" IS
+//
+//     "CHTB"                  MAGIC
+//     uint32 version          1
+//     uint32 entries          NUMBER OF POSITIONS
+//     char[20] signature      NUL-PADDED
+//     uint8[entries]          ONE BYTE PER POSITION, IN INDEX ORDER
+//
+// A BYTE OF 0 IS A DRAW, OR A POSITION THAT CANNOT OCCUR; 1..127 IS A WIN WITH MATE IN THAT MANY MOVES, AND 128 + n A
+// LOSS TO MATE IN n MOVES (128 BEING CHECKMATED). DISTANCES IGNORE THE FIFTY-MOVE RULE. POSITIONS WITH CASTLING RIGHTS
+// ARE NOT COVERED, AND ONLY ONE SIDE MAY HAVE PAWNS, SO EN PASSANT NEVER ARISES
+constexpr int TB_MAX_PIECES = 5;
+constexpr uint8_t TB_DRAW = 0;
+constexpr uint8_t TB_LOSS = 128;
+constexpr size_t TB_HEADER_SIZE = 32;
+
+// THE INDEX RUNS, FROM MOST TO LEAST SIGNIFICANT, OVER THE SIDE TO MOVE, THE WHITE KING, THE BLACK KING AND THE OTHER
+// PIECES IN SIGNATURE ORDER, WHITE'S FIRST. WITHOUT PAWNS THE BOARD IS TURNED AND MIRRORED SO THE WHITE KING STANDS IN
+// THE a1-d1-d4 TRIANGLE; WHILE PIECES ARE ON THE a1-h8 DIAGONAL THE FIRST ONE OFF IT IS PUT BELOW IT, SO EVERY POSITION
+// HAS EXACTLY ONE INDEX. WITH PAWNS THE BOARD IS ONLY MIRRORED LEFT TO RIGHT, PUTTING THE WHITE KING ON FILES a TO d,
+// AND A PAWN ONLY TAKES THE 48 SQUARES OF RANKS 2 TO 7
+int tbTriangle[SQUARE_NB];
+Square tbTriangleSquare[10];
+
+// A SIDE'S MATERIAL AS A NUMBER, TWO BITS FOR THE COUNT OF EACH TYPE FROM PAWN TO QUEEN. A SIDE IN A TABLE HAS AT MOST
+// THREE PIECES BESIDES ITS KING, AND tbMaterialSlot NUMBERS THE 56 WAYS THAT CAN HAPPEN; ANY OTHER KEY HAS SLOT -1
+constexpr int TB_MATERIAL_KEYS = 1 << 10;
+constexpr int TB_MATERIAL_SLOTS = 56;
+int tbMaterialSlot[TB_MATERIAL_KEYS];
+
+int tbMaterialKey(const Position& position, Color c) {
+    int key = 0;
+    for (int pt = PAWN; pt <= QUEEN; pt++) {
+        key |= popcount(position.pieces(c, PieceType(pt))) << (2 * (pt - PAWN));
+    }
+    return key;
+}
+
+void initTablebaseIndex() {
+    int n = 0;
+    for (int s = SQ_A1; s <= SQ_H8; s++) {
+        tbTriangle[s] = -1;
+        if (colOf(Square(s)) <= 3 && (s >> 3) <= colOf(Square(s))) {
+            tbTriangleSquare[n] = Square(s);
+            tbTriangle[s] = n++;
+        }
+    }
+
+    n = 0;
+    for (int key = 0; key < TB_MATERIAL_KEYS; key++) {
+        int pieces = 0;
+        for (int shift = 0; shift < 10; shift += 2) {
+            pieces += (key >> shift) & 3;
+        }
+        tbMaterialSlot[key] = pieces <= TB_MAX_PIECES - 2 ? n++ : -1;
+    }
+}
+
+// THE SIDE WITH MORE MATERIAL COMES FIRST IN A SIGNATURE; ON A TIE, THE ONE THAT SORTS HIGHER
+std::string tbSignature(const std::string& white, const std::string& black) {
+    int whiteValue = 0, blackValue = 0;
+    for (char c : white) {
+        whiteValue += pieceValue[pieceTypeFromChar(c)];
+    }
+    for (char c : black) {
+        blackValue += pieceValue[pieceTypeFromChar(c)];
+    }
+    bool whiteFirst = whiteValue != blackValue ? whiteValue > blackValue : white >= black;
+    return whiteFirst ? white + "v" + black : black + "v" + white;
+}
+
+struct TablebaseMaterial {
+    std::string signature;
+    int count = 0;
+    PieceCode pieces[TB_MAX_PIECES];
+    bool pawns = false;
+    size_t entries = 0;
+    // tbMaterialKey OF EACH SIDE
+    int keys[COLOR_NB] = {0, 0};
+
+    // READS A SIGNATURE IN THE ORDER tbSignature WRITES IT
+    bool parse(const std::string& text) {
+        size_t split = text.find('v');
+        if (split == std::string::npos || text.size() - 1 > size_t(TB_MAX_PIECES) || text.find('v', split + 1) != std::string::npos) {
+            return false;
+        }
+        std::string sides[COLOR_NB] = {text.substr(0, split), text.substr(split + 1)};
+        if (tbSignature(sides[WHITE], sides[BLACK]) != text) {
+            return false;
+        }
+
+        signature = text;
+        count = 2;
+        pieces[0] = W_KING;
+        pieces[1] = B_KING;
+        bool pawnSide[COLOR_NB] = {false, false};
+        for (Color c : {WHITE, BLACK}) {
+            const std::string& side = sides[c];
+            if (side.empty() || side[0] != 'K') {
+                return false;
+            }
+            for (size_t i = 1; i < side.size(); i++) {
+                PieceType pt = pieceTypeFromChar(side[i]);
+                if (pt == NO_PIECE_TYPE || pt == KING || (i > 1 && pt > pieceTypeFromChar(side[i - 1]))) {
+                    return false;
+                }
+                pawnSide[c] = pawnSide[c] || pt == PAWN;
+                keys[c] += 1 << (2 * (pt - PAWN));
+                pieces[count++] = makePiece(c, pt);
+            }
+        }
+        if (pawnSide[WHITE] && pawnSide[BLACK]) {
+            return false;
+        }
+
+        pawns = pawnSide[WHITE] || pawnSide[BLACK];
+        entries = size_t(COLOR_NB) * (pawns ? 32 : 10) * SQUARE_NB;
+        for (int i = 2; i < count; i++) {
+            entries *= typeOf(pieces[i]) == PAWN ? 48 : SQUARE_NB;
+        }
+        return true;
+    }
+
+    // INDEX OF THE POSITION WITH pieces[i] ON squares[i], IN ANY ORIENTATION
+    size_t index(const Square* squares, Color stm) const {
+        Square sq[TB_MAX_PIECES];
+        int mirror = colOf(squares[0]) > 3 ? 7 : 0;
+        if (!pawns && (squares[0] >> 3) > 3) {
+            mirror ^= 56;
+        }
+        bool transpose = false;
+        for (int i = 0; i < count; i++) {
+            sq[i] = Square(squares[i] ^ mirror);
+        }
+        for (int i = 0; i < count && !pawns; i++) {
+            if ((sq[i] >> 3) != colOf(sq[i])) {
+                transpose = (sq[i] >> 3) > colOf(sq[i]);
+                break;
+            }
+        }
+        if (transpose) {
+            for (int i = 0; i < count; i++) {
+                sq[i] = Square((colOf(sq[i]) << 3) | (sq[i] >> 3));
+            }
+        }
+
+        size_t idx = pawns ? size_t(stm) * 32 + (sq[0] >> 3) * 4 + colOf(sq[0]) : size_t(stm) * 10 + tbTriangle[sq[0]];
+        idx = idx * SQUARE_NB + sq[1];
+        for (int i = 2; i < count; i++) {
+            idx = typeOf(pieces[i]) == PAWN ? idx * 48 + (sq[i] - 8) : idx * SQUARE_NB + sq[i];
+        }
+        return idx;
+    }
+
+    // THE SQUARES AND SIDE TO MOVE OF AN INDEX. SOME INDICES DON'T COME BACK FROM index AND ARE NEVER USED
+    void decode(size_t idx, Square* squares, Color& stm) const {
+        for (int i = count - 1; i >= 2; i--) {
+            if (typeOf(pieces[i]) == PAWN) {
+                squares[i] = Square(idx % 48 + 8);
+                idx /= 48;
+            } else {
+                squares[i] = Square(idx % SQUARE_NB);
+                idx /= SQUARE_NB;
+            }
+        }
+        squares[1] = Square(idx % SQUARE_NB);
+        idx /= SQUARE_NB;
+        int kingIndex = int(idx % (pawns ? 32 : 10));
+        squares[0] = pawns ? Square((kingIndex / 4) * 8 + kingIndex % 4) : tbTriangleSquare[kingIndex];
+        stm = Color(idx / (pawns ? 32 : 10));
+    }
+};
+
+// THE LOADED TABLES. EACH FILE IS MAPPED INTO MEMORY AS IT IS, SO LOADING COSTS NOTHING AND A PROBE READS ONE BYTE;
+// THE OPERATING SYSTEM PAGES IN WHAT THE SEARCH ACTUALLY TOUCHES. A PROBE FINDS ITS TABLE IN slots BY THE MATERIAL OF
+// EACH SIDE, WITHOUT BUILDING THE SIGNATURE. READ-ONLY ONCE LOADED, SO ANY THREAD MAY PROBE
+class Tablebases {
+public:
+    Tablebases() = default;
+
+    ~Tablebases() {
+        for (auto& entry : tables) {
+            munmap(entry.second.mapping, entry.second.length);
+        }
+    }
+
+    Tablebases(const Tablebases&) = delete;
+    Tablebases& operator=(const Tablebases&) = delete;
+
+    // MAPS EVERY ".tb" FILE IN THE DIRECTORY AND RETURNS HOW MANY THERE WERE
+    int init(const std::string& directory) {
+        int loaded = 0;
+        std::error_code error;
+        for (const auto& file : std::filesystem::directory_iterator(directory, error)) {
+            if (file.path().extension() == ".tb" && load(file.path().string())) {
+                loaded++;
+            }
+        }
+        return loaded;
+    }
+
+    bool load(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        size_t length = fstat(fd, &info) == 0 ? size_t(info.st_size) : 0;
+        void* mapping = length >= TB_HEADER_SIZE ? mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+
+        const char* header = static_cast<const char*>(mapping);
+        uint32_t version, entries;
+        std::memcpy(&version, header + 4, 4);
+        std::memcpy(&entries, header + 8, 4);
+        Table table;
+        if (std::memcmp(header, "CHTB", 4) != 0 || version != 1 || !table.material.parse(std::string(header + 12, strnlen(header + 12, 20)))
+            || table.material.entries != entries || length != TB_HEADER_SIZE + entries) {
+            munmap(mapping, length);
+            return false;
+        }
+
+        table.mapping = mapping;
+        table.length = length;
+        table.data = reinterpret_cast<const uint8_t*>(header + TB_HEADER_SIZE);
+        auto old = tables.find(table.material.signature);
+        if (old != tables.end()) {
+            munmap(old->second.mapping, old->second.length);
+        }
+        maxPieces = std::max(maxPieces, table.material.count);
+        Table& stored = tables[table.material.signature];
+        stored = table;
+
+        // THE FIRST SIDE OF THE SIGNATURE IS WHITE IN THE TABLE; WITH EQUAL MATERIAL THE COLOURS STAY AS THEY ARE
+        int strong = tbMaterialSlot[table.material.keys[WHITE]];
+        int weak = tbMaterialSlot[table.material.keys[BLACK]];
+        slots[weak][strong] = {&stored, BLACK};
+        slots[strong][weak] = {&stored, WHITE};
+        return true;
+    }
+
+    bool has(const std::string& signature) const {
+        return tables.count(signature) != 0;
+    }
+
+    // THE TABLE BYTE OF THE POSITION FOR THE SIDE TO MOVE; FALSE IF NO LOADED TABLE COVERS IT
+    bool probe(const Chessboard& board, uint8_t& value) const {
+        AllocationGuard guard("Tablebases::probe");
+        const Position& position = board.getPosition();
+        if (popcount(position.pieces()) > maxPieces || board.getCastlingRights() != 0) {
+            return false;
+        }
+        const Slot& slot = slots[tbMaterialSlot[tbMaterialKey(position, WHITE)]][tbMaterialSlot[tbMaterialKey(position, BLACK)]];
+        if (!slot.table) {
+            return false;
+        }
+
+        Color strong = slot.strong;
+        int flip = strong == WHITE ? 0 : 56;
+        Square squares[TB_MAX_PIECES];
+        int n = 0;
+        squares[n++] = Square(position.kingSquare(strong) ^ flip);
+        squares[n++] = Square(position.kingSquare(~strong) ^ flip);
+        for (Color c : {strong, ~strong}) {
+            for (int pt = QUEEN; pt >= PAWN; pt--) {
+                Bitboard b = position.pieces(c, PieceType(pt));
+                while (b) {
+                    squares[n++] = Square(popLsb(b) ^ flip);
+                }
+            }
+        }
+
+        Color stm = board.isWhiteToMove() == (strong == WHITE) ? WHITE : BLACK;
+        value = slot.table->data[slot.table->material.index(squares, stm)];
+        return true;
+    }
+
+    int getMaxPieces() const {
+        return maxPieces;
+    }
+
+private:
+    struct Table {
+        TablebaseMaterial material;
+        const uint8_t* data = nullptr;
+        void* mapping = nullptr;
+        size_t length = 0;
+    };
+
+    // THE TABLE FOR WHITE'S AND BLACK'S tbMaterialSlot, AND THE COLOUR THAT PLAYS WHITE IN IT
+    struct Slot {
+        const Table* table = nullptr;
+        Color strong = WHITE;
+    };
+
+    std::map<std::string, Table> tables;
+    Slot slots[TB_MATERIAL_SLOTS][TB_MATERIAL_SLOTS];
+    int maxPieces = 0;
+};
+
+// THE TABLES THE SEARCH AND THE GAME LOOP PROBE, MAPPED AT START-UP BY "--tb <directory>"
+Tablebases tablebases;
+
+// A TABLE BYTE IN WORDS, FOR THE SIDE TO MOVE
+std::string describeTablebaseValue(uint8_t value) {
+    if (value == TB_DRAW) {
+        return "draw";
+    }
+    if (value == TB_LOSS) {
+        return "checkmated";
+    }
+    return value < TB_LOSS ? "wins, mate in " + std::to_string(value) : "loses, mated in " + std::to_string(value - TB_LOSS);
+}
+
+// THE INDICES OF THE POSITIONS FROM WHICH SIDE us COULD HAVE REACHED squares WITH A MOVE THAT STAYS IN THE TABLE, SO
+// NEITHER A CAPTURE NOR A PROMOTION. SLIDERS, KNIGHTS AND KINGS MOVE BACK THE WAY THEY CAME; PAWNS STEP BACK ONE OR,
+// FROM THE FOURTH RANK, TWO SQUARES
+int tbUnmoves(const TablebaseMaterial& material, const Square* squares, Color us, size_t* parents) {
+    Bitboard occupied = 0;
+    for (int i = 0; i < material.count; i++) {
+        occupied |= squareBB(squares[i]);
+    }
+
+    int n = 0;
+    Square parent[TB_MAX_PIECES];
+    std::copy(squares, squares + material.count, parent);
+    for (int i = 0; i < material.count; i++) {
+        if (colorOf(material.pieces[i]) != us) {
+            continue;
+        }
+        PieceType pt = typeOf(material.pieces[i]);
+        Square s = squares[i];
+        Bitboard origins;
+        if (pt == PAWN) {
+            int back = us == WHITE ? -8 : 8;
+            Square single = Square(s + back);
+            origins = single >= SQ_A2 && single <= SQ_H7 ? squareBB(single) & ~occupied : 0;
+            if (origins && (s >> 3) == (us == WHITE ? 3 : 4)) {
+                origins |= squareBB(Square(single + back)) & ~occupied;
+            }
+        } else {
+            origins = pieceAttacks(pt, us, s, occupied) & ~occupied;
+        }
+
+        while (origins) {
+            parent[i] = popLsb(origins);
+            parents[n++] = material.index(parent, us);
+        }
+        parent[i] = s;
+    }
+    return n;
+}
+
+// RETROGRADE ANALYSIS OF ONE TABLE, WRITTEN TO "<directory>/<signature>.tb" AND THEN LOADED. ANY MISSING TABLE IT
+// CAPTURES OR PROMOTES INTO IS GENERATED FIRST. A FORWARD PASS SETS UP EVERY POSITION ON A Chessboard, SCORES MATES
+// AND STALEMATES, SCORES EACH MOVE LEAVING THE TABLE FROM THE SMALLER ONES, AND COUNTS THE DIFFERENT POSITIONS IN THE
+// TABLE THE OTHER MOVES LEAD TO. THEN, ONE PLY AT A TIME, THE POSITIONS SETTLED IN THE LAST PLY ARE TAKEN BACK A MOVE:
+// WHAT COULD MOVE INTO A LOSS IS WON, AND WHAT COULD MOVE INTO A WIN COUNTS ONE CHILD LESS, AND IS LOST ONCE NONE ARE
+// LEFT UNLESS A MOVE OUT OF THE TABLE SAVES IT. WHATEVER IS NEVER SETTLED IS A DRAW
+bool generateTablebase(const std::string& signature, const std::string& directory) {
+    TablebaseMaterial material;
+    if (!material.parse(signature)) {
+        std::cout << "Cannot generate " << signature << ": the stronger side must come first, at most " << TB_MAX_PIECES
+                  << " pieces, pawns on one side only" << std::endl;
+        return false;
+    }
+
+    // EVERY CAPTURE AND PROMOTION LEADS INTO A SMALLER TABLE
+    std::string sides[COLOR_NB] = {signature.substr(0, signature.find('v')), signature.substr(signature.find('v') + 1)};
+    for (Color c : {WHITE, BLACK}) {
+        for (size_t i = 1; i < sides[c].size(); i++) {
+            std::vector<std::string> children = {sides[c].substr(0, i) + sides[c].substr(i + 1)};
+            if (sides[c][i] == 'P') {
+                for (char promoted : std::string("QRBN")) {
+                    std::string side = sides[c].substr(0, i) + sides[c].substr(i + 1);
+                    size_t at = 1;
+                    while (at < side.size() && pieceTypeFromChar(side[at]) >= pieceTypeFromChar(promoted)) {
+                        at++;
+                    }
+                    children.push_back(side.insert(at, 1, promoted));
+                }
+            }
+            for (const std::string& child : children) {
+                std::string dependency = tbSignature(c == WHITE ? child : sides[WHITE], c == WHITE ? sides[BLACK] : child);
+                if (dependency != "KvK" && !tablebases.has(dependency) && !tablebases.load(directory + "/" + dependency + ".tb")
+                    && !generateTablebase(dependency, directory)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    enum : uint8_t {UNKNOWN, WON, LOST, DRAWN, LOSING, UNUSED};
+    // A DRAWING MOVE OUT OF THE TABLE IS RECORDED AS A CONVERSION LOSS THIS LONG, LONGER THAN ANY REAL ONE
+    constexpr uint8_t CONVERSION_DRAW = 255;
+
+    auto start = std::chrono::steady_clock::now();
+    size_t n = material.entries;
+    // state AND plies: THE RESULT SO FAR AND, ONCE SETTLED, ITS DISTANCE IN PLIES (A LOSING POSITION IS LOST FOR SURE
+    // BUT ONLY SETTLES AT THAT DISTANCE). remaining: CHILDREN IN THE TABLE NOT YET KNOWN TO WIN FOR THE OPPONENT.
+    // conversionWin AND conversionLoss: THE SHORTEST WIN AND LONGEST LOSS BY MOVES OUT OF THE TABLE, IN PLIES
+    std::vector<uint8_t> state(n, UNKNOWN), plies(n, 0), remaining(n, 0), conversionWin(n, 0), conversionLoss(n, 0);
+    int longestConversion = 0;
+
+    Chessboard board;
+    Square squares[TB_MAX_PIECES], child[TB_MAX_PIECES];
+    size_t children[MAX_MOVES];
+    for (size_t i = 0; i < n; i++) {
+        Color stm;
+        material.decode(i, squares, stm);
+        bool used = material.index(squares, stm) == i;
+        Position position;
+        for (int k = 0; k < material.count && used; k++) {
+            used = position.isEmpty(squares[k]);
+            position.putPiece(material.pieces[k], squares[k]);
+        }
+        if (!used || (position.attackersTo(position.kingSquare(~stm), position.pieces()) & position.pieces(stm))) {
+            state[i] = UNUSED;
+            continue;
+        }
+
+        board.setPosition(position, stm);
+        MoveList moves;
+        board.generateMoves(stm == WHITE, moves);
+        if (moves.empty()) {
+            state[i] = board.inCheck() ? LOST : DRAWN;
+            continue;
+        }
+
+        int childCount = 0;
+        for (Move move : moves) {
+            if (position.isEmpty(move.to()) && move.type() != PROMOTION) {
+                std::copy(squares, squares + material.count, child);
+                *std::find(child, child + material.count, move.from()) = move.to();
+                children[childCount++] = material.index(child, ~stm);
+                continue;
+            }
+
+            board.makeMove(move);
+            uint8_t value = TB_DRAW;
+            if (popcount(board.getPosition().pieces()) > 2 && !tablebases.probe(board, value)) {
+                std::cout << "No table for a capture or promotion from " << board.toFEN() << std::endl;
+                return false;
+            }
+            board.unmakeMove(move);
+
+            if (value == TB_DRAW) {
+                conversionLoss[i] = CONVERSION_DRAW;
+            } else if (value < TB_LOSS) {
+                conversionLoss[i] = std::max(conversionLoss[i], uint8_t(2 * value));
+            } else if (conversionWin[i] == 0 || 2 * (value - TB_LOSS) + 1 < conversionWin[i]) {
+                conversionWin[i] = uint8_t(2 * (value - TB_LOSS) + 1);
+            }
+        }
+        if (conversionLoss[i] != CONVERSION_DRAW) {
+            longestConversion = std::max<int>(longestConversion, std::max(conversionWin[i], conversionLoss[i]));
+        }
+
+        std::sort(children, children + childCount);
+        remaining[i] = uint8_t(std::unique(children, children + childCount) - children);
+        if (remaining[i] == 0 && conversionWin[i] == 0) {
+            state[i] = conversionLoss[i] == CONVERSION_DRAW ? DRAWN : LOSING;
+            plies[i] = conversionLoss[i];
+        }
+    }
+
+    // PLY p SETTLES WINS IN p PLIES WHEN p IS ODD AND LOSSES WHEN IT IS EVEN
+    int ply = 1;
+    int quietPlies = 0;
+    for (; ply < 255 && (ply <= longestConversion || quietPlies < 2); ply++) {
+        bool wins = ply % 2 == 1;
+        size_t settled = 0;
+        for (size_t j = 0; j < n; j++) {
+            if (state[j] != (wins ? LOST : WON) || plies[j] != ply - 1) {
+                continue;
+            }
+            Color stm;
+            material.decode(j, squares, stm);
+            int parentCount = tbUnmoves(material, squares, ~stm, children);
+            std::sort(children, children + parentCount);
+            parentCount = int(std::unique(children, children + parentCount) - children);
+
+            for (int k = 0; k < parentCount; k++) {
+                size_t i = children[k];
+                if (state[i] != UNKNOWN) {
+                    continue;
+                }
+                if (wins) {
+                    state[i] = WON;
+                    plies[i] = uint8_t(ply);
+                    settled++;
+                } else if (--remaining[i] == 0 && conversionWin[i] == 0) {
+                    state[i] = conversionLoss[i] == CONVERSION_DRAW ? DRAWN : LOSING;
+                    plies[i] = std::max(uint8_t(ply), conversionLoss[i]);
+                }
+            }
+        }
+
+        // MOVES OUT OF THE TABLE SETTLE THEIR POSITIONS AT THEIR OWN DISTANCE
+        for (size_t i = 0; i < n; i++) {
+            if (wins && state[i] == UNKNOWN && conversionWin[i] == ply) {
+                state[i] = WON;
+                plies[i] = uint8_t(ply);
+            } else if (!wins && state[i] == LOSING && plies[i] == ply) {
+                state[i] = LOST;
+            } else {
+                continue;
+            }
+            settled++;
+        }
+        quietPlies = settled ? 0 : quietPlies + 1;
+    }
+    if (ply == 255) {
+        std::cout << "Cannot generate " << signature << ": a mate is longer than the format can hold" << std::endl;
+        return false;
+    }
+
+    // THE TABLE BYTES REPLACE THE DISTANCES
+    size_t counts[3] = {0, 0, 0};
+    int longest = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (state[i] == WON) {
+            longest = std::max(longest, (plies[i] + 1) / 2);
+            plies[i] = uint8_t((plies[i] + 1) / 2);
+            counts[0]++;
+        } else if (state[i] == LOST) {
+            plies[i] = uint8_t(TB_LOSS + plies[i] / 2);
+            counts[2]++;
+        } else {
+            plies[i] = TB_DRAW;
+            counts[1] += state[i] != UNUSED;
+        }
+    }
+
+    std::string path = directory + "/" + signature + ".tb";
+    std::ofstream out(path, std::ios::binary);
+    char header[TB_HEADER_SIZE] = {};
+    uint32_t version = 1, entries = uint32_t(n);
+    std::memcpy(header, "CHTB", 4);
+    std::memcpy(header + 4, &version, 4);
+    std::memcpy(header + 8, &entries, 4);
+    std::memcpy(header + 12, signature.data(), signature.size());
+    out.write(header, TB_HEADER_SIZE);
+    out.write(reinterpret_cast<const char*>(plies.data()), std::streamsize(n));
+    out.close();
+    if (!out || !tablebases.load(path)) {
+        std::cout << "Could not write " << path << std::endl;
+        return false;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << signature << ": " << counts[0] << " won, " << counts[1] << " drawn, " << counts[2] << " lost, longest mate "
+              << longest << " moves, " << std::fixed << std::setprecision(1) << seconds << "s" << std::endl;
+    return true;
+}
+
+// SEARCH
+
+constexpr int MAX_PLY = 128;
+// DEPTH USED BY THE "hint" AND "go" COMMANDS OF THE GAME LOOP
+constexpr int DEFAULT_SEARCH_DEPTH = 5;
+// DEPTH OF EACH "bench" SEARCH UNLESS ANOTHER IS GIVEN
+constexpr int DEFAULT_BENCH_DEPTH = 10;
+// TRANSPOSITION TABLE SIZE UNLESS "--hash <MB>" IS GIVEN
+constexpr size_t DEFAULT_HASH_MB = 16;
+// MATE - ply FOR GIVING MATE ply HALF-MOVES FROM THE ROOT; ANY SCORE BEYOND MATE_BOUND IS A MATE SCORE
+constexpr int MATE = 32000;
+constexpr int MATE_BOUND = MATE - MAX_PLY;
+constexpr int INFINITE_SCORE = MATE + 1;
+
+// SCORE OF A LEAF IN CENTIPAWNS FROM THE SIDE TO MOVE'S POINT OF VIEW, FROM THE NETWORK IF ONE WAS LOADED
+int evaluate(Chessboard& board) {
+    return useNNUE ? board.evaluateNNUE() : board.evaluate();
+}
+
+// TRANSPOSITION TABLE: A POWER-OF-TWO NUMBER OF 64-BYTE BUCKETS, EACH HOLDING FOUR ENTRIES AND FILLING ONE CACHE
+// LINE. THREADS SHARE IT WITHOUT LOCKS: AN ENTRY IS TWO 64-BIT WORDS, THE DATA AND THE KEY XORED WITH THE DATA, SO
+// AN ENTRY TORN BY TWO THREADS WRITING AT ONCE SIMPLY FAILS THE KEY CHECK ON THE NEXT PROBE
+enum Bound { BOUND_NONE, BOUND_UPPER, BOUND_LOWER, BOUND_EXACT };
+
+struct TTEntry {
+    Move move;
+    int score;
+    int depth;
+    Bound bound;
+};
+
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t megabytes) {
+        resize(megabytes);
+    }
+
+    // ROUNDS THE SIZE DOWN TO A POWER OF TWO NUMBER OF BUCKETS AND CLEARS THE TABLE
+    void resize(size_t megabytes) {
+        size_t count = 1;
+        while (count * 2 * sizeof(Bucket) <= std::max<size_t>(megabytes, 1) * 1024 * 1024) {
+            count *= 2;
+        }
+        buckets.reset(new Bucket[count]);
+        mask = count - 1;
+        clear();
+    }
+
+    void clear() {
+        for (size_t i = 0; i <= mask; i++) {
+            for (Slot& slot : buckets[i].slots) {
+                slot.keyXorData.store(0, std::memory_order_relaxed);
+                slot.data.store(0, std::memory_order_relaxed);
+            }
+        }
+        generation = 0;
+    }
+
+    // CALLED AT THE START OF EVERY SEARCH, SO ENTRIES FROM EARLIER SEARCHES ARE REPLACED FIRST
+    void newSearch() {
+        generation = (generation + 1) & 63;
+    }
+
+    void prefetch(uint64_t key) const {
+        __builtin_prefetch(&buckets[key & mask]);
+    }
+
+    bool probe(uint64_t key, TTEntry& entry) const {
+        for (const Slot& slot : buckets[key & mask].slots) {
+            uint64_t data = slot.data.load(std::memory_order_relaxed);
+            if ((slot.keyXorData.load(std::memory_order_relaxed) ^ data) == key && data) {
+                entry.move = Move(uint16_t(data));
+                entry.score = int16_t(data >> 16);
+                entry.depth = int(uint8_t(data >> 32));
+                entry.bound = Bound((data >> 40) & 3);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // REPLACES THE ENTRY FOR THE SAME KEY IF THERE IS ONE, OTHERWISE THE SHALLOWEST ENTRY, COUNTING EACH SEARCH
+    // OF AGE AS EIGHT PLIES OF DEPTH LOST
+    void store(uint64_t key, Move move, int score, int depth, Bound bound) {
+        Slot* replace = nullptr;
+        int worst = 1 << 30;
+
+        for (Slot& slot : buckets[key & mask].slots) {
+            uint64_t data = slot.data.load(std::memory_order_relaxed);
+            if ((slot.keyXorData.load(std::memory_order_relaxed) ^ data) == key) {
+                // KEEP A KNOWN BEST MOVE IF THE NEW RESULT DIDN'T FIND ONE, AND A DEEPER RESULT FROM THIS SEARCH
+                if (move == MOVE_NONE) {
+                    move = Move(uint16_t(data));
+                }
+                if (bound != BOUND_EXACT && int(uint8_t(data >> 32)) > depth + 2 && int((data >> 42) & 63) == generation) {
+                    return;
+                }
+                replace = &slot;
+                break;
+            }
+
+            int age = (generation - int((data >> 42) & 63)) & 63;
+            int value = int(uint8_t(data >> 32)) - 8 * age;
+            if (value < worst) {
+                worst = value;
+                replace = &slot;
+            }
+        }
+
+        uint64_t data = uint64_t(move.raw())
+                      | uint64_t(uint16_t(int16_t(score))) << 16
+                      | uint64_t(uint8_t(std::max(depth, 0))) << 32
+                      | uint64_t(bound) << 40
+                      | uint64_t(generation) << 42;
+        replace->data.store(data, std::memory_order_relaxed);
+        replace->keyXorData.store(key ^ data, std::memory_order_relaxed);
+    }
+
+    // PERMILLE OF THE ENTRIES IN THE FIRST 250 BUCKETS (A THOUSAND SLOTS) WRITTEN IN THE CURRENT SEARCH
+    int hashfull() const {
+        int used = 0;
+        for (size_t i = 0; i < std::min<size_t>(250, mask + 1); i++) {
+            for (const Slot& slot : buckets[i].slots) {
+                uint64_t data = slot.data.load(std::memory_order_relaxed);
+                used += data && int((data >> 42) & 63) == generation;
+            }
+        }
+        return used * 1000 / (4 * int(std::min<size_t>(250, mask + 1)));
+    }
+
+private:
+    // DATA LAYOUT: MOVE (BITS 0-15), SCORE (16-31), DEPTH (32-39), BOUND (40-41), GENERATION (42-47)
+    struct Slot {
+        std::atomic<uint64_t> keyXorData;
+        std::atomic<uint64_t> data;
+    };
+
+    struct alignas(64) Bucket {
+        Slot slots[4];
+    };
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t mask;
+    int generation;
+};
+
+// LIMITS OF ONE SEARCH; TIMES ARE IN MILLISECONDS AND ZERO MEANS NO LIMIT. time AND increment ARE THE GAME CLOCKS,
+// movestogo THE MOVES LEFT UNTIL THE NEXT TIME CONTROL (ZERO FOR SUDDEN DEATH). AN infinite SEARCH IGNORES THE CLOCKS
+// AND RUNS UNTIL IT IS STOPPED OR REACHES ITS DEPTH
+struct SearchLimits {
+    int depth = 0;
+    uint64_t nodes = 0;
+    int64_t movetime = 0;
+    int64_t time[COLOR_NB] = {0, 0};
+    int64_t increment[COLOR_NB] = {0, 0};
+    int movestogo = 0;
+    bool infinite = false;
+};
+
+// TIME KEPT BACK ON EVERY MOVE FOR PRINTING IT AND FOR WHATEVER RELAYS IT
+constexpr int64_t MOVE_OVERHEAD = 10;
+// MOVES THE CLOCK IS ASSUMED TO LAST FOR WHEN THERE IS NO movestogo
+constexpr int DEFAULT_MOVES_TO_GO = 30;
+
+// TURNS THE LIMITS INTO TWO DEADLINES, IN MILLISECONDS SINCE THE START: NO NEW ITERATION IS STARTED AFTER THE SOFT
+// ONE, SINCE IT WOULD MOST LIKELY NOT FINISH, AND THE SEARCH IS STOPPED WHEREVER IT IS AT THE HARD ONE. ZERO MEANS
+// NO DEADLINE
+class TimeManager {
+public:
+    void init(const SearchLimits& limits, Color us) {
+        start = std::chrono::steady_clock::now();
+        softLimit = hardLimit = 0;
+        if (limits.infinite) {
+            return;
+        }
+
+        if (limits.movetime > 0) {
+            softLimit = hardLimit = std::max(limits.movetime - MOVE_OVERHEAD, int64_t(1));
+        } else if (limits.time[us] > 0) {
+            // AIM FOR AN EVEN SHARE OF THE CLOCK PLUS MOST OF THE INCREMENT; A SINGLE MOVE MAY TAKE UP TO THREE
+            // SHARES BUT NEVER MORE THAN 80% OF WHAT IS LEFT
+            int64_t remaining = std::max(limits.time[us] - MOVE_OVERHEAD, int64_t(1));
+            int movesToGo = limits.movestogo > 0 ? limits.movestogo : DEFAULT_MOVES_TO_GO;
+            int64_t target = remaining / movesToGo + limits.increment[us] * 3 / 4;
+            hardLimit = std::max(std::min(target * 3, remaining * 4 / 5), int64_t(1));
+            softLimit = std::max(std::min(target / 2, hardLimit), int64_t(1));
+        }
+    }
+
+    int64_t elapsed() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    bool softExpired() const {
+        return softLimit > 0 && elapsed() >= softLimit;
+    }
+
+    bool hardExpired() const {
+        return hardLimit > 0 && elapsed() >= hardLimit;
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+    int64_t softLimit = 0;
+    int64_t hardLimit = 0;
+};
+
+// WHAT THE THREADS OF ONE SEARCH SHARE BESIDES THE TRANSPOSITION TABLE: THE LIMITS AND DEADLINES, A STOP SIGNAL, AND
+// THE NODE COUNT THAT EACH THREAD ADDS TO IN BATCHES OF NODE_BATCH. THE LIMITS ARE CHECKED ONCE PER BATCH, WHICH
+// TAKES WELL UNDER A MILLISECOND. WHILE ponder IS SET THE SEARCH IS ON THE OPPONENT'S TIME AND IGNORES THE DEPTH,
+// TIME AND NODE LIMITS; THEY APPLY AGAIN FROM THE PONDER HIT, COUNTED FROM THE START OF THE PONDER SEARCH
+constexpr uint64_t NODE_BATCH = 1024;
+
+struct SearchShared {
+    SearchLimits limits;
+    TimeManager time;
+    std::atomic<bool> stop{false};
+    std::atomic<bool> ponder{false};
+    std::atomic<uint64_t> nodes{0};
+};
+
+// QUIET MOVES ARE ORDERED BY HOW OFTEN THEY CAUSED A CUTOFF; THE SCORES STAY BELOW THIS
+constexpr int HISTORY_MAX = 800;
+
+// A CAPTURE IN THE QUIESCENCE SEARCH IS SKIPPED IF WINNING THE CAPTURED PIECE AND THIS MUCH MORE WOULD STILL NOT
+// REACH alpha
+constexpr int DELTA_MARGIN = 200;
+
+// SELECTIVE SEARCH. NULL MOVE: IF THE SIDE TO MOVE COULD PASS AND STILL REACH beta WITH A SEARCH NULL_MOVE_REDUCTION
+// (PLUS ONE PER SIX PLIES) SHALLOWER, THE NODE IS CUT. AT NULL_VERIFY_DEPTH AND DEEPER THE CUT IS CHECKED BY A
+// REDUCED SEARCH WITHOUT NULL MOVES, AGAINST ZUGZWANG THE MATERIAL RULE MISSES
+constexpr int NULL_MOVE_REDUCTION = 3;
+constexpr int NULL_VERIFY_DEPTH = 10;
+// REVERSE FUTILITY: A NODE WHOSE STATIC EVALUATION BEATS beta BY THIS MUCH PER PLY OF DEPTH LEFT IS CUT, UP TO
+// REVERSE_FUTILITY_DEPTH
+constexpr int REVERSE_FUTILITY_DEPTH = 6;
+constexpr int REVERSE_FUTILITY_MARGIN = 80;
+// FUTILITY: A QUIET MOVE THAT GIVES NO CHECK IS SKIPPED IF THE STATIC EVALUATION PLUS THIS MUCH PER PLY OF DEPTH LEFT
+// STILL DOESN'T REACH alpha, UP TO FUTILITY_DEPTH
+constexpr int FUTILITY_DEPTH = 3;
+constexpr int FUTILITY_MARGIN = 120;
+// LATE MOVE REDUCTIONS START WITH THE MOVE AFTER THE FIRST LMR_MOVES AND AT LMR_DEPTH
+constexpr int LMR_MOVES = 3;
+constexpr int LMR_DEPTH = 3;
+
+// EACH PART OF THE SELECTIVE SEARCH CAN BE SWITCHED OFF WITH "--disable", SO ITS SAVING CAN BE MEASURED WITH "bench"
+struct SearchFeatures {
+    bool nullMove = true;
+    bool lateMoveReductions = true;
+    bool reverseFutility = true;
+    bool futility = true;
+    bool checkExtensions = true;
+};
+
+SearchFeatures features;
+
+// PLIES BY WHICH A LATE QUIET MOVE IS REDUCED, BY DEPTH AND MOVE NUMBER: LOGARITHMIC IN BOTH, SO A MOVE IS CUT
+// HARDER THE LATER THE PICKER HANDS IT OUT
+int reductions[64][64];
+
+void initReductions() {
+    for (int depth = 1; depth < 64; depth++) {
+        for (int moveCount = 1; moveCount < 64; moveCount++) {
+            reductions[depth][moveCount] = int(0.75 + std::log(double(depth)) * std::log(double(moveCount)) / 2.25);
+        }
+    }
+}
+
+// HANDS OUT THE MOVES OF A POSITION ONE AT A TIME IN STAGES: THE HASH MOVE, CAPTURES THAT LOOK SAFE BY MOST VALUABLE
+// VICTIM / LEAST VALUABLE ATTACKER, THE TWO KILLER MOVES, THE COUNTERMOVE, QUIET MOVES BY HISTORY, AND LAST THE
+// CAPTURES THAT LOOK LIKE THEY LOSE MATERIAL. QUIET MOVES ARE ONLY GENERATED IF NO EARLIER MOVE CAUSED A CUTOFF
+class MovePicker {
+public:
+    MovePicker(const Chessboard& board, Move ttMove, const Move* killers, Move counterMove, const int (*history)[SQUARE_NB])
+        : board(board), position(board.getPosition()), ttMove(ttMove), counterMove(counterMove), history(history),
+          stage(STAGE_TT_MOVE), current(0), capturesOnly(false) {
+        this->killers[0] = killers[0];
+        this->killers[1] = killers[1];
+    }
+
+    // FOR THE QUIESCENCE SEARCH: ONLY THE CAPTURES AND PROMOTIONS THAT DON'T LOSE MATERIAL
+    explicit MovePicker(const Chessboard& board)
+        : board(board), position(board.getPosition()), ttMove(MOVE_NONE), counterMove(MOVE_NONE), history(nullptr),
+          stage(STAGE_GENERATE_CAPTURES), current(0), capturesOnly(true) {
+        killers[0] = killers[1] = MOVE_NONE;
+    }
+
+    // THE NEXT MOVE TO SEARCH, OR MOVE_NONE ONCE EVERY LEGAL MOVE HAS BEEN HANDED OUT
+    Move next() {
+        switch (stage) {
+            case STAGE_TT_MOVE:
+                stage = STAGE_GENERATE_CAPTURES;
+                if (board.isLegal(ttMove)) {
+                    return ttMove;
+                }
+                [[fallthrough]];
+
+            case STAGE_GENERATE_CAPTURES:
+                board.generateMoves<CAPTURES>(moves);
+                scoreCaptures();
+                current = 0;
+                stage = STAGE_GOOD_CAPTURES;
+                [[fallthrough]];
+
+            case STAGE_GOOD_CAPTURES:
+                while (current < moves.size()) {
+                    Move move = pickBest();
+                    if (move == ttMove) {
+                        continue;
+                    }
+                    if (losesMaterial(move)) {
+                        badCaptures.add(move);
+                        continue;
+                    }
+                    return move;
+                }
+                if (capturesOnly) {
+                    stage = STAGE_DONE;
+                    break;
+                }
+                stage = STAGE_KILLER_1;
+                [[fallthrough]];
+
+            case STAGE_KILLER_1:
+                stage = STAGE_KILLER_2;
+                if (isUsableQuiet(killers[0])) {
+                    return killers[0];
+                }
+                [[fallthrough]];
+
+            case STAGE_KILLER_2:
+                stage = STAGE_COUNTER_MOVE;
+                if (killers[1] != killers[0] && isUsableQuiet(killers[1])) {
+                    return killers[1];
+                }
+                [[fallthrough]];
+
+            case STAGE_COUNTER_MOVE:
+                stage = STAGE_GENERATE_QUIETS;
+                if (counterMove != killers[0] && counterMove != killers[1] && isUsableQuiet(counterMove)) {
+                    return counterMove;
+                }
+                [[fallthrough]];
+
+            case STAGE_GENERATE_QUIETS:
+                moves.clear();
+                board.generateMoves<QUIETS>(moves);
+                for (int i = 0; i < moves.size(); i++) {
+                    scores[i] = history[moves[i].from()][moves[i].to()];
+                }
+                current = 0;
+                stage = STAGE_QUIETS;
+                [[fallthrough]];
+
+            case STAGE_QUIETS:
+                while (current < moves.size()) {
+                    Move move = pickBest();
+                    if (move != ttMove && move != killers[0] && move != killers[1] && move != counterMove) {
+                        return move;
+                    }
+                }
+                current = 0;
+                stage = STAGE_BAD_CAPTURES;
+                [[fallthrough]];
+
+            case STAGE_BAD_CAPTURES:
+                if (current < badCaptures.size()) {
+                    return badCaptures[current++];
+                }
+                stage = STAGE_DONE;
+                [[fallthrough]];
+
+            case STAGE_DONE:
+                break;
+        }
+        return MOVE_NONE;
+    }
+
+private:
+    enum Stage {
+        STAGE_TT_MOVE, STAGE_GENERATE_CAPTURES, STAGE_GOOD_CAPTURES, STAGE_KILLER_1, STAGE_KILLER_2, STAGE_COUNTER_MOVE,
+        STAGE_GENERATE_QUIETS, STAGE_QUIETS, STAGE_BAD_CAPTURES, STAGE_DONE
+    };
+
+    const Chessboard& board;
+    const Position& position;
+    Move ttMove;
+    Move killers[2];
+    Move counterMove;
+    const int (*history)[SQUARE_NB];
+    Stage stage;
+    MoveList moves;
+    MoveList badCaptures;
+    int scores[MAX_MOVES];
+    int current;
+    bool capturesOnly;
+
+    PieceType capturedType(Move move) const {
+        return move.type() == EN_PASSANT ? PAWN : typeOf(position.pieceOn(move.to()));
+    }
+
+    // MOST VALUABLE VICTIM FIRST, THE LEAST VALUABLE ATTACKER BREAKING TIES; A PROMOTION ADDS THE NEW PIECE
+    void scoreCaptures() {
+        for (int i = 0; i < moves.size(); i++) {
+            Move move = moves[i];
+            PieceType victim = capturedType(move);
+            scores[i] = (victim != NO_PIECE_TYPE ? 10 * pieceValue[victim] : 0) - pieceValue[typeOf(position.pieceOn(move.from()))] / 10;
+            if (move.type() == PROMOTION) {
+                scores[i] += pieceValue[move.promotionType()];
+            }
+        }
+    }
+
+    // ONLY A CAPTURE OF A CHEAPER PIECE CAN LOSE MATERIAL, SO THE EXCHANGE IS ONLY WORKED OUT FOR THOSE
+    bool losesMaterial(Move move) const {
+        return pieceValue[typeOf(position.pieceOn(move.from()))] > pieceValue[capturedType(move)] && board.see(move) < 0;
+    }
+
+    // A KILLER OR COUNTERMOVE IS ONLY HANDED OUT EARLY IF IT IS STILL A LEGAL QUIET MOVE HERE THAT WASN'T TRIED YET
+    bool isUsableQuiet(Move move) const {
+        return move != MOVE_NONE && move != ttMove && move.type() == NORMAL && position.isEmpty(move.to()) && board.isLegal(move);
+    }
+
+    // SELECTION SORT ONE STEP AT A TIME: AFTER A CUTOFF THE REST OF THE LIST IS NEVER SORTED
+    Move pickBest() {
+        int best = current;
+        for (int i = current + 1; i < moves.size(); i++) {
+            if (scores[i] > scores[best]) {
+                best = i;
+            }
+        }
+        std::swap(moves[best], moves[current]);
+        std::swap(scores[best], scores[current]);
+        return moves[current++];
+    }
+};
+
+// NEGAMAX ALPHA-BETA WITH ITERATIVE DEEPENING, PRINCIPAL VARIATION SEARCH AND ASPIRATION WINDOWS. THE BOARD IS
+// SEARCHED IN PLACE WITH makeMove/unmakeMove AND IS BACK IN ITS STARTING POSITION WHEN think RETURNS. ONE OBJECT
+// PER THREAD; THE LIMITS COME FROM THE SearchShared OF THE ThreadPool
+class Search {
+public:
+    Search(Chessboard& board, TranspositionTable& tt, SearchShared& shared) : board(board), tt(tt), shared(&shared) {
+        std::memset(history, 0, sizeof(history));
+        std::fill(&killers[0][0], &killers[0][0] + MAX_PLY * 2, MOVE_NONE);
+        std::fill(&counterMoves[0][0], &counterMoves[0][0] + PIECE_CODE_NB * SQUARE_NB, MOVE_NONE);
+    }
+
+    // SEARCHES UNTIL THE LIMITS ARE REACHED OR THE SEARCH IS STOPPED, OPTIONALLY PRINTING ONE LINE PER COMPLETED
+    // ITERATION, AND RETURNS THE BEST MOVE. ONLY THE MAIN THREAD STOPS AT THE SOFT DEADLINE; A HELPER THREAD STARTS
+    // AT A LATER firstDepth SO THE THREADS DON'T ALL WORK ON THE SAME ITERATION
+    Move think(bool mainThread, bool verbose = false, int firstDepth = 1) {
+        const SearchLimits& limits = shared->limits;
+        int depthLimit = limits.depth > 0 ? std::min(limits.depth, MAX_PLY - 1) : MAX_PLY - 1;
+        nodes = 0;
+        stopped = false;
+        start = std::chrono::steady_clock::now();
+        previousPvLength = 0;
+        completedDepth = 0;
+        lastScore = 0;
+        nullMinPly = 0;
+
+        Move bestMove = MOVE_NONE;
+        int score = 0;
+
+        for (int depth = std::min(firstDepth, depthLimit); depth < MAX_PLY; depth++) {
+            // FROM DEPTH 4 ON, START WITH A NARROW WINDOW AROUND THE LAST SCORE AND WIDEN IT ON EACH FAIL
+            int delta = 25;
+            int alpha = -INFINITE_SCORE, beta = INFINITE_SCORE;
+            if (depth >= 4) {
+                alpha = std::max(score - delta, -INFINITE_SCORE);
+                beta = std::min(score + delta, INFINITE_SCORE);
+            }
+
+            while (true) {
+                followPv = true;
+                score = search(alpha, beta, depth, 0);
+
+                if (stopped) {
+                    break;
+                }
+                if (score <= alpha) {
+                    alpha = std::max(alpha - delta, -INFINITE_SCORE);
+                } else if (score >= beta) {
+                    beta = std::min(beta + delta, INFINITE_SCORE);
+                } else {
+                    break;
+                }
+                delta *= 2;
+            }
+
+            // AN ITERATION CUT SHORT BY THE STOP SIGNAL IS THROWN AWAY
+            if (stopped || pvLength[0] == 0) {
+                break; // NO LEGAL MOVES AT THE ROOT
+            }
+            bestMove = pv[0][0];
+            completedDepth = depth;
+            lastScore = score;
+            previousPvLength = pvLength[0];
+            std::copy(pv[0], pv[0] + pvLength[0], previousPv);
+
+            if (verbose) {
+                report(depth, score);
+            }
+
+            // A MATE WITHIN THE SEARCHED DEPTH WON'T GET ANY SHORTER; ONE FROM THE TABLEBASES BEYOND IT STILL MIGHT
+            if (std::abs(score) >= MATE_BOUND && MATE - std::abs(score) <= depth) {
+                break;
+            }
+            if (shared->ponder.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            if (depth >= depthLimit) {
+                break;
+            }
+            if (mainThread && (shared->time.softExpired() || (limits.nodes > 0 && shared->nodes.load(std::memory_order_relaxed) >= limits.nodes))) {
+                break;
+            }
+        }
+        shared->nodes.fetch_add(nodes % NODE_BATCH, std::memory_order_relaxed);
+        return bestMove;
+    }
+
+    uint64_t getNodes() const {
+        return nodes;
+    }
+
+    // DEPTH AND SCORE OF THE LAST ITERATION think COMPLETED
+    int getCompletedDepth() const {
+        return completedDepth;
+    }
+
+    int getScore() const {
+        return lastScore;
+    }
+
+    // THE REPLY THE LAST COMPLETED ITERATION EXPECTS TO THE BEST MOVE, OR MOVE_NONE IF ITS PV STOPS AT THE BEST MOVE
+    Move getPonderMove() const {
+        return previousPvLength > 1 ? previousPv[1] : MOVE_NONE;
+    }
+
+private:
+    Chessboard& board;
+    TranspositionTable& tt;
+    SearchShared* shared;
+    uint64_t nodes;
+    bool stopped;
+    int completedDepth;
+    int lastScore;
+    std::chrono::steady_clock::time_point start;
+
+    // CUTOFF COUNTS OF QUIET MOVES BY SIDE, FROM AND TO SQUARE; EACH THREAD HAS ITS OWN
+    int history[COLOR_NB][SQUARE_NB][SQUARE_NB];
+    // THE LAST TWO QUIET MOVES THAT CAUSED A CUTOFF AT EACH PLY
+    Move killers[MAX_PLY][2];
+    // THE QUIET MOVE THAT LAST REFUTED A MOVE, BY THE PIECE THAT MOVED AND ITS DESTINATION
+    Move counterMoves[PIECE_CODE_NB][SQUARE_NB];
+    // THE MOVE BEING SEARCHED AT EACH PLY
+    Move currentMove[MAX_PLY];
+    // NULL MOVES ARE OFF BELOW THIS PLY WHILE A NULL-MOVE CUT IS BEING VERIFIED
+    int nullMinPly;
+
+    // TRIANGULAR PV TABLE: pv[ply] HOLDS THE BEST LINE FOUND FROM ply ONWARDS
+    Move pv[MAX_PLY][MAX_PLY];
+    int pvLength[MAX_PLY];
+    // THE PV OF THE LAST COMPLETED ITERATION, TRIED FIRST WHILE THE SEARCH IS STILL FOLLOWING IT
+    Move previousPv[MAX_PLY];
+    int previousPvLength;
+    bool followPv;
+
+    // COUNTS THE NODE. ONCE PER NODE_BATCH NODES IT ADDS THE BATCH TO THE SHARED COUNT, CHECKS THE NODE LIMIT, THE
+    // HARD DEADLINE AND, FOR A PONDER SEARCH THAT WENT PAST IT BEFORE THE HIT, THE DEPTH LIMIT, AND PICKS UP THE STOP
+    // SIGNAL. A THREAD ONLY STOPS THE SEARCH ITSELF ONCE IT HAS COMPLETED AN ITERATION, SO THERE IS ALWAYS A MOVE TO PLAY
+    bool checkStop() {
+        if (++nodes % NODE_BATCH == 0) {
+            uint64_t total = shared->nodes.fetch_add(NODE_BATCH, std::memory_order_relaxed) + NODE_BATCH;
+            const SearchLimits& limits = shared->limits;
+            if (completedDepth > 0 && !shared->ponder.load(std::memory_order_relaxed)
+                && ((limits.nodes > 0 && total >= limits.nodes) || shared->time.hardExpired() || (limits.depth > 0 && completedDepth >= limits.depth))) {
+                shared->stop = true;
+            }
+            stopped = stopped || shared->stop.load(std::memory_order_relaxed);
+        }
+        return stopped;
+    }
+
+    int search(int alpha, int beta, int depth, int ply) {
+        // A CHECK IS ANSWERED ONE PLY DEEPER, SO THE HORIZON DOESN'T CUT A FORCING LINE OFF HALFWAY
+        bool inCheck = board.inCheck();
+        if (inCheck && features.checkExtensions) {
+            depth++;
+        }
+        if (depth <= 0) {
+            return quiescence(alpha, beta, ply);
+        }
+
+        pvLength[ply] = 0;
+        if (checkStop()) {
+            return 0;
+        }
+
+        if (ply > 0 && board.isDraw(2)) {
+            return 0;
+        }
+        if (ply >= MAX_PLY - 1) {
+            return evaluate(board);
+        }
+
+        // A POSITION IN THE TABLEBASES HAS AN EXACT SCORE. THE ROOT IS STILL SEARCHED, SO A MOVE IS CHOSEN
+        uint8_t tbValue;
+        if (ply > 0 && popcount(board.getPosition().pieces()) <= tablebases.getMaxPieces() && tablebases.probe(board, tbValue)) {
+            return scoreFromTablebase(tbValue, ply);
+        }
+
+        // A STORED RESULT THAT IS DEEP ENOUGH ENDS THE NODE, EXCEPT ON THE PV WHERE THE LINE ITSELF IS WANTED
+        bool pvNode = beta - alpha > 1;
+        int alphaOriginal = alpha;
+        TTEntry entry;
+        bool ttHit = tt.probe(board.getKey(), entry);
+        Move ttMove = ttHit ? entry.move : MOVE_NONE;
+        if (ttHit && !pvNode && entry.depth >= depth) {
+            int score = scoreFromTT(entry.score, ply);
+            if (entry.bound == BOUND_EXACT || (entry.bound == BOUND_LOWER && score >= beta) || (entry.bound == BOUND_UPPER && score <= alpha)) {
+                return score;
+            }
+        }
+
+        // WHILE THE SEARCH IS STILL ON THE PREVIOUS ITERATION'S PV, ITS MOVE GOES FIRST INSTEAD OF THE HASH MOVE
+        if (followPv && ply < previousPvLength && board.isLegal(previousPv[ply])) {
+            ttMove = previousPv[ply];
+        } else {
+            followPv = false;
+        }
+
+        Color us = board.isWhiteToMove() ? WHITE : BLACK;
+        Move previous = ply > 0 ? currentMove[ply - 1] : MOVE_NONE;
+
+        // THE PRUNING BELOW ONLY HAPPENS OFF THE PV AND OUT OF CHECK, AND IS DRIVEN BY THE STATIC EVALUATION
+        int staticEval = pvNode || inCheck ? -INFINITE_SCORE : evaluate(board);
+        if (!pvNode && !inCheck) {
+            // REVERSE FUTILITY: SO FAR ABOVE beta THAT NO REPLY WITHIN THE DEPTH LEFT IS LIKELY TO BRING IT BACK
+            if (features.reverseFutility && depth <= REVERSE_FUTILITY_DEPTH && std::abs(beta) < MATE_BOUND
+                && staticEval - REVERSE_FUTILITY_MARGIN * depth >= beta) {
+                return staticEval;
+            }
+
+            // NULL MOVE: NEVER TWICE IN A ROW, AND NEVER WITH ONLY PAWNS LEFT, WHERE ZUGZWANG IS COMMON. THE MOVE
+            // BEFORE A NULL MOVE IS MOVE_NONE, WHICH ALSO KEEPS ITS COUNTERMOVE OUT OF THE CHILD'S ORDERING
+            const Position& position = board.getPosition();
+            if (features.nullMove && depth >= 2 && ply >= nullMinPly && previous != MOVE_NONE && staticEval >= beta
+                && (position.pieces(us) & ~(position.pieces(PAWN) | position.pieces(KING)))) {
+                int reduction = NULL_MOVE_REDUCTION + depth / 6;
+                currentMove[ply] = MOVE_NONE;
+                board.makeNullMove();
+                int score = -search(-beta, -beta + 1, depth - 1 - reduction, ply + 1);
+                board.unmakeNullMove();
+                if (stopped) {
+                    return 0;
+                }
+
+                if (score >= beta) {
+                    // A MATE FOUND AFTER PASSING ISN'T PROVEN
+                    if (score >= MATE_BOUND) {
+                        score = beta;
+                    }
+                    if (depth < NULL_VERIFY_DEPTH || nullMinPly > 0) {
+                        return score;
+                    }
+
+                    // THE VERIFICATION SEARCH MAY NOT USE NULL MOVES ITSELF FOR ITS FIRST THREE QUARTERS
+                    nullMinPly = ply + 3 * (depth - reduction) / 4;
+                    int verified = search(beta - 1, beta, depth - reduction, ply);
+                    nullMinPly = 0;
+                    if (stopped) {
+                        return 0;
+                    }
+                    if (verified >= beta) {
+                        return score;
+                    }
+                }
+            }
+        }
+
+        Move counterMove = previous != MOVE_NONE ? counterMoves[board.getPosition().pieceOn(previous.to())][previous.to()] : MOVE_NONE;
+        MovePicker picker(board, ttMove, killers[ply], counterMove, history[us]);
+
+        int bestScore = -INFINITE_SCORE;
+        Move bestMove = MOVE_NONE;
+        int moveCount = 0;
+        for (Move move = picker.next(); move != MOVE_NONE; move = picker.next()) {
+            moveCount++;
+            bool quiet = board.getPosition().isEmpty(move.to()) && move.type() == NORMAL;
+            bool givesCheck = board.givesCheck(move);
+
+            // FUTILITY: NEAR THE HORIZON A QUIET MOVE WON'T MAKE UP A LARGE DEFICIT, UNLESS IT GIVES CHECK
+            if (features.futility && !pvNode && !inCheck && !givesCheck && quiet && moveCount > 1 && depth <= FUTILITY_DEPTH
+                && bestScore > -MATE_BOUND && staticEval + FUTILITY_MARGIN * depth <= alpha) {
+                continue;
+            }
+
+            currentMove[ply] = move;
+            tt.prefetch(board.keyAfter(move));
+            board.makeMove(move);
+
+            // LATE MOVE REDUCTIONS: A QUIET MOVE THE PICKER HANDS OUT LATE IS FIRST SEARCHED SHALLOWER. IT IS REDUCED
+            // LESS ON THE PV, AS A KILLER OR COUNTERMOVE, OR WITH A GOOD HISTORY
+            int reduction = 0;
+            if (features.lateMoveReductions && quiet && !inCheck && !givesCheck && depth >= LMR_DEPTH && moveCount > LMR_MOVES) {
+                reduction = reductions[std::min(depth, 63)][std::min(moveCount, 63)];
+                if (pvNode) {
+                    reduction--;
+                }
+                if (move == killers[ply][0] || move == killers[ply][1] || move == counterMove) {
+                    reduction--;
+                }
+                if (history[us][move.from()][move.to()] >= HISTORY_MAX / 2) {
+                    reduction--;
+                }
+                reduction = std::max(0, std::min(reduction, depth - 2));
+            }
+
+            // THE FIRST MOVE GETS THE FULL WINDOW; THE REST ONLY HAVE TO PROVE THEY ARE NO BETTER. A REDUCED MOVE
+            // THAT FAILS TO IS SEARCHED AGAIN AT FULL DEPTH, AND ONE THAT STILL DOES WITH THE FULL WINDOW
+            int score;
+            if (moveCount == 1) {
+                score = -search(-beta, -alpha, depth - 1, ply + 1);
+            } else {
+                score = -search(-alpha - 1, -alpha, depth - 1 - reduction, ply + 1);
+                if (reduction > 0 && score > alpha) {
+                    score = -search(-alpha - 1, -alpha, depth - 1, ply + 1);
+                }
+                if (score > alpha && score < beta) {
+                    score = -search(-beta, -alpha, depth - 1, ply + 1);
+                }
+            }
+
+            board.unmakeMove(move);
+            followPv = false;
+            if (stopped) {
+                return 0;
+            }
+
+            if (score > bestScore) {
+                bestScore = score;
+                if (score > alpha) {
+                    alpha = score;
+                    bestMove = move;
+                    pv[ply][0] = move;
+                    std::copy(pv[ply + 1], pv[ply + 1] + pvLength[ply + 1], pv[ply] + 1);
+                    pvLength[ply] = pvLength[ply + 1] + 1;
+
+                    if (alpha >= beta) {
+                        if (board.getPosition().isEmpty(move.to()) && move.type() == NORMAL) {
+                            updateQuietStats(move, previous, depth, ply);
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (moveCount == 0) {
+            return inCheck ? -MATE + ply : 0;
+        }
+
+        Bound bound = bestScore >= beta ? BOUND_LOWER : bestScore > alphaOriginal ? BOUND_EXACT : BOUND_UPPER;
+        tt.store(board.getKey(), bestMove, scoreToTT(bestScore, ply), depth, bound);
+        return bestScore;
+    }
+
+    // AT THE HORIZON, KEEP SEARCHING CAPTURES UNTIL THE POSITION IS QUIET, SO A SCORE IS NEVER TAKEN IN THE MIDDLE OF
+    // AN EXCHANGE. THE SIDE TO MOVE MAY ALSO STAND PAT ON THE STATIC EVALUATION; CAPTURES THAT LOSE MATERIAL BY SEE, OR
+    // THAT COULD NOT LIFT THE SCORE TO alpha EVEN WITH DELTA_MARGIN TO SPARE, ARE SKIPPED. IN CHECK EVERY EVASION IS
+    // SEARCHED, SO MATES AT THE HORIZON ARE STILL SEEN
+    int quiescence(int alpha, int beta, int ply) {
+        pvLength[ply] = 0;
+        if (checkStop()) {
+            return 0;
+        }
+
+        if (board.isDraw(2)) {
+            return 0;
+        }
+        if (ply >= MAX_PLY - 1) {
+            return evaluate(board);
+        }
+
+        bool inCheck = board.inCheck();
+        int standPat = -INFINITE_SCORE;
+        int bestScore = -INFINITE_SCORE;
+        if (!inCheck) {
+            standPat = bestScore = evaluate(board);
+            if (standPat >= beta) {
+                return standPat;
+            }
+            alpha = std::max(alpha, standPat);
+        }
+
+        Color us = board.isWhiteToMove() ? WHITE : BLACK;
+        MovePicker picker = inCheck ? MovePicker(board, MOVE_NONE, killers[ply], MOVE_NONE, history[us]) : MovePicker(board);
+        const Position& position = board.getPosition();
+        int moveCount = 0;
+
+        for (Move move = picker.next(); move != MOVE_NONE; move = picker.next()) {
+            moveCount++;
+            if (!inCheck && move.type() != PROMOTION) {
+                PieceType victim = move.type() == EN_PASSANT ? PAWN : typeOf(position.pieceOn(move.to()));
+                if (standPat + pieceValue[victim] + DELTA_MARGIN <= alpha) {
+                    continue;
+                }
+            }
+
+            board.makeMove(move);
+            int score = -quiescence(-beta, -alpha, ply + 1);
+            board.unmakeMove(move);
+            if (stopped) {
+                return 0;
+            }
+
+            if (score > bestScore) {
+                bestScore = score;
+                if (score > alpha) {
+                    alpha = score;
+                    pv[ply][0] = move;
+                    std::copy(pv[ply + 1], pv[ply + 1] + pvLength[ply + 1], pv[ply] + 1);
+                    pvLength[ply] = pvLength[ply + 1] + 1;
+                    if (alpha >= beta) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (inCheck && moveCount == 0) {
+            return -MATE + ply;
+        }
+        return bestScore;
+    }
+
+    // A QUIET MOVE CAUSED A CUTOFF: IT BECOMES THE FIRST KILLER AT THIS PLY AND THE COUNTERMOVE TO THE PREVIOUS MOVE,
+    // AND ITS HISTORY GROWS. THE BONUS SHRINKS AS THE ENTRY APPROACHES HISTORY_MAX, WHICH IT NEVER PASSES
+    void updateQuietStats(Move move, Move previous, int depth, int ply) {
+        if (killers[ply][0] != move) {
+            killers[ply][1] = killers[ply][0];
+            killers[ply][0] = move;
+        }
+        if (previous != MOVE_NONE) {
+            counterMoves[board.getPosition().pieceOn(previous.to())][previous.to()] = move;
+        }
+
+        int& entry = history[board.isWhiteToMove() ? WHITE : BLACK][move.from()][move.to()];
+        int bonus = std::min(depth * depth, HISTORY_MAX);
+        entry += bonus - entry * bonus / HISTORY_MAX;
+    }
+
+    // A TABLE WIN OR LOSS BECOMES A MATE SCORE FROM THE ROOT; ONE TOO FAR AWAY FOR MAX_PLY STAYS JUST BELOW MATE_BOUND
+    static int scoreFromTablebase(uint8_t value, int ply) {
+        if (value == TB_DRAW) {
+            return 0;
+        }
+        int distance = value < TB_LOSS ? ply + 2 * value - 1 : ply + 2 * (value - TB_LOSS);
+        int score = distance < MAX_PLY ? MATE - distance : MATE_BOUND - 1;
+        return value < TB_LOSS ? score : -score;
+    }
+
+    // MATE SCORES ARE STORED AS DISTANCE FROM THE STORED POSITION, NOT FROM THE ROOT
+    static int scoreToTT(int score, int ply) {
+        return score >= MATE_BOUND ? score + ply : score <= -MATE_BOUND ? score - ply : score;
+    }
+
+    static int scoreFromTT(int score, int ply) {
+        return score >= MATE_BOUND ? score - ply : score <= -MATE_BOUND ? score + ply : score;
+    }
+
+    // ONE LINE PER ITERATION: DEPTH, SCORE (CENTIPAWNS OR MATE IN MOVES), NODES AND SPEED OF ALL THREADS, TIME AND PV
+    void report(int depth, int score) const {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        uint64_t totalNodes = shared->nodes.load(std::memory_order_relaxed) + nodes % NODE_BATCH;
+
+        std::cout << "info depth " << depth << " score ";
+        if (std::abs(score) >= MATE_BOUND) {
+            std::cout << "mate " << (score > 0 ? (MATE - score + 1) / 2 : -(MATE + score) / 2);
+        } else {
+            std::cout << "cp " << score;
+        }
+        std::cout << " nodes " << totalNodes << " nps " << uint64_t(seconds > 0 ? totalNodes / seconds : 0)
+                  << " hashfull " << tt.hashfull() << " time " << int(seconds * 1000) << " pv";
+        for (int i = 0; i < pvLength[0]; i++) {
+            std::cout << " " << moveToUCI(pv[0][i]);
+        }
+        std::cout << std::endl;
+    }
+};
+
+// LAZY SMP: EVERY THREAD RUNS THE SAME ITERATIVE DEEPENING SEARCH ON ITS OWN COPY OF THE BOARD, WITH ITS OWN HISTORY,
+// AND THEY ONLY COOPERATE THROUGH THE SHARED TRANSPOSITION TABLE. EVERY THREAD WAITS FOR WORK BETWEEN SEARCHES, SO A
+// SEARCH CAN RUN IN THE BACKGROUND WHILE THE CALLER DOES SOMETHING ELSE; THREAD 0 PRINTS THE OUTPUT AND THE HELPERS
+// ARE STOPPED AS SOON AS IT FINISHES
+class ThreadPool {
+public:
+    ThreadPool(TranspositionTable& tt, int threadCount) : tt(tt) {
+        workers.resize(std::max(threadCount, 1));
+        for (size_t i = 0; i < workers.size(); i++) {
+            workers[i].thread = std::thread(&ThreadPool::idleLoop, this, int(i));
+        }
+    }
+
+    ~ThreadPool() {
+        stop();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this] { return pending == 0; });
+            quit = true;
+        }
+        wake.notify_all();
+        for (Worker& worker : workers) {
+            worker.thread.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // STARTS SEARCHING THE POSITION ON root WITHIN THE LIMITS WITH EVERY THREAD AND RETURNS AT ONCE. A PONDER SEARCH
+    // KEEPS DEEPENING PAST THE LIMITS UNTIL ponderHit OR stop. THE PREVIOUS SEARCH MUST HAVE BEEN WAITED FOR
+    void start(const Chessboard& root, const SearchLimits& limits, bool ponder = false, bool verbose = true) {
+        tt.newSearch();
+        shared.limits = limits;
+        shared.time.init(limits, root.isWhiteToMove() ? WHITE : BLACK);
+        shared.stop = false;
+        shared.ponder = ponder;
+        shared.nodes = 0;
+        this->verbose = verbose;
+        for (Worker& worker : workers) {
+            worker.board.reset(new Chessboard(root));
+            worker.search.reset(new Search(*worker.board, tt, shared));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending = int(workers.size());
+            searchId++;
+        }
+        wake.notify_all();
+    }
+
+    // WAITS FOR THE SEARCH TO FINISH AND RETURNS THE MOVE THE THREADS VOTE FOR
+    Move wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return pending == 0; });
+        Move best = vote();
+        ponderMove = MOVE_NONE;
+        for (const Worker& worker : workers) {
+            if (worker.bestMove == best) {
+                ponderMove = worker.search->getPonderMove();
+                break;
+            }
+        }
+        return best;
+    }
+
+    // SEARCHES THE POSITION ON root WITHIN THE LIMITS WITH EVERY THREAD AND RETURNS THE MOVE THE THREADS VOTE FOR
+    Move think(const Chessboard& root, const SearchLimits& limits, bool verbose = true) {
+        start(root, limits, false, verbose);
+        return wait();
+    }
+
+    // THE OPPONENT PLAYED THE MOVE THE PONDER SEARCH EXPECTED: FROM NOW ON THE SEARCH KEEPS TO ITS LIMITS, AND IF IT
+    // IS ALREADY DEEPER THAN ITS DEPTH LIMIT IT STOPS WITHIN A BATCH OF NODES
+    void ponderHit() {
+        shared.ponder = false;
+    }
+
+    void stop() {
+        shared.stop = true;
+    }
+
+    // THE REPLY THE LAST SEARCH WAITED FOR EXPECTS TO ITS MOVE
+    Move getPonderMove() const {
+        return ponderMove;
+    }
+
+    // FORGETS EVERYTHING LEARNED IN EARLIER SEARCHES, SO THE NEXT ONE STARTS AS IF THE PROGRAM HAD JUST STARTED
+    void clear() {
+        tt.clear();
+    }
+
+    int size() const {
+        return int(workers.size());
+    }
+
+    uint64_t getNodes() const {
+        return shared.nodes.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Worker {
+        std::unique_ptr<Chessboard> board;
+        std::unique_ptr<Search> search;
+        Move bestMove;
+        std::thread thread;
+    };
+
+    TranspositionTable& tt;
+    SearchShared shared;
+    std::vector<Worker> workers;
+    bool verbose = true;
+    Move ponderMove = MOVE_NONE;
+
+    // THREADS SLEEP ON wake UNTIL searchId CHANGES; THE LAST ONE TO FINISH SIGNALS done
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    int searchId = 0;
+    int pending = 0;
+    bool quit = false;
+
+    void idleLoop(int index) {
+        int lastSearch = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return quit || searchId != lastSearch; });
+                if (quit) {
+                    return;
+                }
+                lastSearch = searchId;
+            }
+
+            // ODD HELPERS START ONE ITERATION AHEAD, SO HALF THE THREADS ARE ALWAYS ON A DIFFERENT DEPTH
+            Worker& worker = workers[index];
+            if (index == 0) {
+                worker.bestMove = worker.search->think(true, verbose);
+                shared.stop = true;
+            } else {
+                worker.bestMove = worker.search->think(false, false, 1 + index % 2);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) {
+                done.notify_all();
+            }
+        }
+    }
+
+    // EACH THREAD VOTES FOR ITS BEST MOVE WITH A WEIGHT THAT GROWS WITH ITS DEPTH AND WITH HOW MUCH BETTER ITS SCORE IS
+    // THAN THE WORST ONE. THREAD 0 WINS TIES
+    Move vote() const {
+        int minScore = INFINITE_SCORE;
+        for (const Worker& worker : workers) {
+            if (worker.bestMove != MOVE_NONE) {
+                minScore = std::min(minScore, worker.search->getScore());
+            }
+        }
+
+        std::map<uint16_t, int64_t> votes;
+        Move best = workers[0].bestMove;
+        for (const Worker& worker : workers) {
+            if (worker.bestMove == MOVE_NONE) {
+                continue;
+            }
+            int64_t& total = votes[worker.bestMove.raw()];
+            total += int64_t(worker.search->getScore() - minScore + 14) * worker.search->getCompletedDepth();
+            if (best == MOVE_NONE || total > votes[best.raw()]) {
+                best = worker.bestMove;
+            }
+        }
+        return best;
+    }
+};
+
+// FILLS EVERY LOOKUP TABLE. CALLED ONCE AT START-UP, BEFORE ANY Chessboard IS USED; FROM THEN ON THE TABLES ARE
+// READ-ONLY, SO ANY NUMBER OF BOARDS CAN BE USED FROM DIFFERENT THREADS AT THE SAME TIME
+void initTables() {
+    initBitboards();
+    initMagics(BISHOP, bishopMagics, bishopTable);
+    initMagics(ROOK, rookMagics, rookTable);
+    initLineTables();
+    initZobrist();
+    initPieceSquareTables();
+    initNnueKernels();
+    initReductions();
+    initTablebaseIndex();
+}
+
+// WELL-KNOWN PERFT POSITIONS AND THEIR NODE COUNTS, USED TO CHECK THE MOVE GENERATOR AFTER EVERY CHANGE
+struct PerftCase {
+    const char* name;
+    const char* fen;
+    int depth;
+    uint64_t nodes;
+};
+
+const PerftCase perftSuite[] = {
+    {"startpos",  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609},
+    {"kiwipete",  "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603},
+    {"endgame",   "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624},
+    {"promotion", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333},
+    {"underpromo","n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1", 5, 3605103},
+    {"castling",  "r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1", 4, 314346},
+    {"talkchess", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487},
+    {"middlegame","r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594},
+};
+
+// PRINTS NODES, TIME AND NODES PER SECOND FOR ONE PERFT RUN
+void printPerftResult(uint64_t nodes, double seconds) {
+    std::cout << "Nodes: " << nodes << "  Time: " << std::fixed << std::setprecision(3) << seconds << "s"
+              << "  NPS: " << uint64_t(seconds > 0 ? nodes / seconds : 0) << std::endl;
+}
+
+// RUNS THE WHOLE SUITE; RETURNS THE NUMBER OF POSITIONS WHOSE COUNT DIDN'T MATCH
+int runPerftSuite() {
+    Chessboard chessboard;
+    uint64_t totalNodes = 0;
+    double totalSeconds = 0;
+    int failures = 0;
+
+    for (const PerftCase& test : perftSuite) {
+        chessboard.loadFEN(test.fen);
+        auto start = std::chrono::steady_clock::now();
+        uint64_t nodes = chessboard.perft(test.depth);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        bool ok = nodes == test.nodes;
+        failures += ok ? 0 : 1;
+        totalNodes += nodes;
+        totalSeconds += seconds;
+
+        std::cout << std::left << std::setw(11) << test.name << std::right << " depth " << test.depth << "  "
+                  << (ok ? "OK  " : "FAIL") << " (expected " << test.nodes << ")  ";
+        printPerftResult(nodes, seconds);
+    }
+
+    std::cout << "Total  ";
+    printPerftResult(totalNodes, totalSeconds);
+    std::cout << (failures == 0 ? "All perft counts match." : "Perft mismatch!") << std::endl;
+    return failures;
+}
+
+// COMMAND LINE MODES:
+//   perft <depth> [fen]    NODE COUNT FROM THE GIVEN POSITION (START POSITION BY DEFAULT)
+//   divide <depth> [fen]   THE SAME, SPLIT BY ROOT MOVE
+//   perftsuite             THE REFERENCE POSITIONS ABOVE
+//   search <depth> [fen]   BEST MOVE FROM A FIXED-DEPTH SEARCH
+int runCommandLine(int argc, char* argv[], ThreadPool& threads) {
+    std::string mode = argv[1];
+
+    if (mode == "perftsuite") {
+        return runPerftSuite() == 0 ? 0 : 1;
+    }
+
+    if (mode == "nnue-export" && argc > 2) {
+        Network net;
+        makeDefaultNetwork(net);
+        if (!saveNetwork(argv[2], net)) {
+            std::cout << "Could not write " << argv[2] << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // "tb-generate" WRITES THE NAMED TABLES, AND ANY SMALLER ONES THEY NEED THAT AREN'T THERE YET, INTO A DIRECTORY
+    if (mode == "tb-generate" && argc > 3) {
+        std::error_code error;
+        std::filesystem::create_directories(argv[2], error);
+        tablebases.init(argv[2]);
+        for (int i = 3; i < argc; i++) {
+            if (!generateTablebase(argv[i], argv[2])) {
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    // "tb-probe" LOOKS A POSITION UP IN THE TABLES GIVEN WITH "--tb"
+    if (mode == "tb-probe" && argc > 2) {
+        std::string fen = argv[2];
+        for (int i = 3; i < argc; i++) {
+            fen += std::string(" ") + argv[i];
+        }
+        Chessboard chessboard;
+        uint8_t value;
+        if (!chessboard.loadFEN(fen.c_str())) {
+            std::cout << "Invalid FEN: " << fen << std::endl;
+            return 1;
+        }
+        if (!tablebases.probe(chessboard, value)) {
+            std::cout << "Not in the tablebases" << std::endl;
+            return 1;
+        }
+        std::cout << describeTablebaseValue(value) << std::endl;
+        return 0;
+    }
+
+    // "go" TAKES ITS LIMITS AS KEYWORD/VALUE PAIRS, OR THE BARE FLAG "infinite", FOLLOWED BY "fen" AND A POSITION IF
+    // THE START POSITION ISN'T WANTED
+    if (mode == "go") {
+        SearchLimits limits;
+        std::string fen = START_FEN;
+        for (int i = 2; i < argc; i++) {
+            std::string key = argv[i];
+            if (key == "infinite") {
+                limits.infinite = true;
+                continue;
+            }
+            if (i + 1 >= argc) {
+                std::cout << "Missing value for: " << key << std::endl;
+                return 1;
+            }
+            if (key == "fen") {
+                fen = argv[++i];
+                while (i + 1 < argc) {
+                    fen += std::string(" ") + argv[++i];
+                }
+                break;
+            }
+            int64_t value = std::strtoll(argv[++i], nullptr, 10);
+            if (key == "depth") {
+                limits.depth = int(value);
+            } else if (key == "nodes") {
+                limits.nodes = uint64_t(value);
+            } else if (key == "movetime") {
+                limits.movetime = value;
+            } else if (key == "wtime") {
+                limits.time[WHITE] = value;
+            } else if (key == "btime") {
+                limits.time[BLACK] = value;
+            } else if (key == "winc") {
+                limits.increment[WHITE] = value;
+            } else if (key == "binc") {
+                limits.increment[BLACK] = value;
+            } else if (key == "movestogo") {
+                limits.movestogo = int(value);
+            } else {
+                std::cout << "Unknown limit: " << key << std::endl;
+                return 1;
+            }
+        }
+
+        Chessboard chessboard;
+        if (!chessboard.loadFEN(fen.c_str())) {
+            std::cout << "Invalid FEN: " << fen << std::endl;
+            return 1;
+        }
+        Move best = threads.think(chessboard, limits);
+        std::cout << "bestmove " << (best == MOVE_NONE ? "(none)" : moveToUCI(best)) << std::endl;
+        return 0;
+    }
+
+    // "bench" SEARCHES EVERY PERFT SUITE POSITION TO A FIXED DEPTH FROM AN EMPTY TABLE. WITH ONE THREAD THE NODE COUNT
+    // ONLY CHANGES WITH THE SEARCH ITSELF, SO IT MEASURES WHAT EACH "--disable" COSTS OR SAVES
+    if (mode == "bench") {
+        SearchLimits limits;
+        limits.depth = argc > 2 ? std::atoi(argv[2]) : DEFAULT_BENCH_DEPTH;
+        // A DEPTH OF ZERO WOULD MEAN NO LIMIT, SO A MISTYPED ONE WOULD NEVER FINISH
+        if (limits.depth < 1) {
+            std::cout << "Depth must be at least 1: " << argv[2] << std::endl;
+            return 1;
+        }
+        uint64_t totalNodes = 0;
+        double totalSeconds = 0;
+        for (const PerftCase& test : perftSuite) {
+            Chessboard chessboard;
+            chessboard.loadFEN(test.fen);
+            threads.clear();
+            auto start = std::chrono::steady_clock::now();
+            Move best = threads.think(chessboard, limits, false);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << std::left << std::setw(12) << test.name << std::right << " bestmove " << std::setw(5) << moveToUCI(best)
+                      << "  nodes " << std::setw(10) << threads.getNodes() << std::endl;
+            totalNodes += threads.getNodes();
+            totalSeconds += seconds;
+        }
+        std::cout << "Total: ";
+        printPerftResult(totalNodes, totalSeconds);
+        return 0;
+    }
+
+    if ((mode == "perft" || mode == "divide" || mode == "search") && argc > 2) {
+        int depth = std::atoi(argv[2]);
+        if (mode == "search" && depth < 1) {
+            std::cout << "Depth must be at least 1: " << argv[2] << std::endl;
+            return 1;
+        }
+        std::string fen = START_FEN;
+        if (argc > 3) {
+            // THE FEN MAY ARRIVE QUOTED AS ONE ARGUMENT OR SPLIT INTO ITS SIX FIELDS
+            fen = argv[3];
+            for (int i = 4; i < argc; i++) {
+                fen += std::string(" ") + argv[i];
+            }
+        }
+
+        Chessboard chessboard;
+        if (!chessboard.loadFEN(fen.c_str())) {
+            std::cout << "Invalid FEN: " << fen << std::endl;
+            return 1;
+        }
+
+        if (mode == "search") {
+            SearchLimits limits;
+            limits.depth = depth;
+            Move best = threads.think(chessboard, limits);
+            std::cout << "bestmove " << (best == MOVE_NONE ? "(none)" : moveToUCI(best)) << std::endl;
+            return 0;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        uint64_t nodes = mode == "perft" ? chessboard.perft(depth) : chessboard.divide(depth);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printPerftResult(nodes, seconds);
+        return 0;
+    }
+
+    std::cout << "Usage: chess [--hash <MB>] [--threads <N>] [--nnue <file|builtin>] [--disable <features>] [--tb <dir>] [perft <depth> [fen] | divide <depth> [fen] | perftsuite"
+              << " | search <depth> [fen] | go [infinite] [depth|nodes|movetime|wtime|btime|winc|binc|movestogo <n>]... [fen <fen>]"
+              << " | bench [depth] | nnue-export <file> | tb-generate <dir> <signature>... | tb-probe <fen>]" << std::endl;
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    initTables();
+
+    // OPTIONS COME BEFORE ANY OTHER ARGUMENT: "--hash <MB>" SETS THE TRANSPOSITION TABLE SIZE, "--threads <N>" THE
+    // NUMBER OF SEARCH THREADS (ONE PER HARDWARE THREAD BY DEFAULT) AND "--nnue <file>" MAKES THE SEARCH EVALUATE
+    // WITH A NETWORK ("builtin" FOR THE BUNDLED ONE). "--disable <features>" SWITCHES OFF A COMMA-SEPARATED LIST OF
+    // SELECTIVE SEARCH FEATURES: null, lmr, rfp, futility, checkext. "--tb <dir>" MAPS THE ENDGAME TABLES IN A DIRECTORY
+    size_t hashMegabytes = DEFAULT_HASH_MB;
+    int threadCount = std::max(int(std::thread::hardware_concurrency()), 1);
+    while (argc > 2 && (std::string(argv[1]) == "--hash" || std::string(argv[1]) == "--threads" || std::string(argv[1]) == "--nnue"
+                        || std::string(argv[1]) == "--disable" || std::string(argv[1]) == "--tb")) {
+        if (std::string(argv[1]) == "--hash") {
+            hashMegabytes = std::strtoul(argv[2], nullptr, 10);
+        } else if (std::string(argv[1]) == "--threads") {
+            threadCount = std::max(std::atoi(argv[2]), 1);
+        } else if (std::string(argv[1]) == "--tb") {
+            int loaded = tablebases.init(argv[2]);
+            std::cout << "info string " << loaded << " tablebases, up to " << tablebases.getMaxPieces() << " pieces" << std::endl;
+        } else if (std::string(argv[1]) == "--disable") {
+            std::stringstream list(argv[2]);
+            std::string feature;
+            while (std::getline(list, feature, ',')) {
+                if (feature == "null") {
+                    features.nullMove = false;
+                } else if (feature == "lmr") {
+                    features.lateMoveReductions = false;
+                } else if (feature == "rfp") {
+                    features.reverseFutility = false;
+                } else if (feature == "futility") {
+                    features.futility = false;
+                } else if (feature == "checkext") {
+                    features.checkExtensions = false;
+                } else {
+                    std::cout << "Unknown feature " << feature << std::endl;
+                    return 1;
+                }
+            }
+        } else {
+            if (!loadNetwork(argv[2], network)) {
+                std::cout << "Could not load network " << argv[2] << std::endl;
+                return 1;
+            }
+            useNNUE = true;
+            std::cout << "info string NNUE " << argv[2] << " hidden " << network.hidden << " kernels " << nnueKernels.name << std::endl;
+        }
+        argv[2] = argv[0];
+        argc -= 2;
+        argv += 2;
+    }
+    TranspositionTable tt(hashMegabytes);
+    ThreadPool threads(tt, threadCount);
+
+    if (argc > 1) {
+        return runCommandLine(argc, argv, threads);
+    }
+
+    Chessboard chessboard;
+    chessboard.initializeBoard();
+
+    // WHITE ALWAYS STARTS FIRST
+    bool whiteTurn = true;
+    // CHECKMATE VARIABLE TO DETERMINE WHETHER GAME ENDS
+    bool checkmate = false;
+    // ALTERNATIVELY, DRAW IF MOVE REPETITION OR 50-MOVE RULE
+    bool draw = false;
+    // TEMPORARY TURN LIMIT
+    int i = 0;
+    // WITH PONDERING ON, THE COMPUTER KEEPS SEARCHING AFTER ITS MOVE, ON THE POSITION AFTER THE REPLY IT EXPECTS.
+    // THAT SEARCH RUNS UNTIL THE GAME LEAVES THE LINE, OR IS TAKEN OVER BY THE NEXT "hint" OR "go" ON ITS POSITION
+    bool ponderEnabled = false;
+    bool pondering = false;
+    uint64_t ponderKey = 0;
+
+    while (!checkmate && !draw) {
+        chessboard.displayBoard();
+        chessboard.printPiecePositions(); 
+        std::string input;
+
+        // ONCE THE POSITION IS IN THE TABLEBASES, THE RESULT IS KNOWN
+        uint8_t tbValue;
+        if (tablebases.probe(chessboard, tbValue)) {
+            std::cout << "Tablebase: " << (tbValue == TB_DRAW ? "" : whiteTurn ? "White " : "Black ") << describeTablebaseValue(tbValue) << std::endl;
+        }
+
+        bool valid = false;
+        while (valid == false) {
+            chessboard.generateLegalMoves(whiteTurn); // Generate legal moves for the current player
+            chessboard.printLegalMoves(whiteTurn);   // Print legal moves for the current player
+
+            // NO LEGAL MOVES AND NOT MATED BY THE LAST MOVE: STALEMATE
+            if ((whiteTurn ? chessboard.getWhiteLegalMoves() : chessboard.getBlackLegalMoves()).empty()) {
+                draw = true;
+                std::cout << "Stalemate! Game drawn." << std::endl;
+                break;
+            }
+
+            std::cout << std::endl;
+
+            const std::vector<std::string>& movesLog = chessboard.getMovesLog();
+            for (size_t moveNumber = 0; moveNumber < movesLog.size(); ++moveNumber) {
+                // Print the move number before white's move
+                if (moveNumber % 2 == 0) {
+                    std::cout << moveNumber / 2 + 1 << ". ";
+                }
+                
+                // Print the player's move
+                std::cout << movesLog[moveNumber];
+
+                // Add a space after every move
+                std::cout << " ";
+            }
+            std::cout << std::endl;
+
+            if (i % 2 == 0) {
+                std::cout << "White to move. " << ((i-(i%2))/2)+1 << ". ";
+            } else {
+                std::cout << "Black to move. " << ((i-(i%2))/2)+1 << ". ";
+            }
+
+            std::cin >> input;
+            std::cout << std::endl;
+
+            // "ponder" SWITCHES PONDERING ON OR OFF
+            if (input == "ponder") {
+                ponderEnabled = !ponderEnabled;
+                if (!ponderEnabled && pondering) {
+                    threads.stop();
+                    threads.wait();
+                    pondering = false;
+                }
+                std::cout << "Pondering " << (ponderEnabled ? "enabled" : "disabled") << std::endl;
+                continue;
+            }
+
+            // "hint" SUGGESTS A MOVE, "go" LETS THE COMPUTER PLAY ONE
+            Move move = MOVE_NONE;
+            if (input == "hint" || input == "go") {
+                if (pondering && chessboard.getKey() != ponderKey) {
+                    threads.stop();
+                    threads.wait();
+                    pondering = false;
+                }
+                if (pondering) {
+                    // THE PONDER SEARCH IS ALREADY ON THIS POSITION: IT ONLY HAS TO FINISH
+                    threads.ponderHit();
+                    move = threads.wait();
+                    pondering = false;
+                    std::cout << "Ponder hit" << std::endl;
+                } else {
+                    SearchLimits limits;
+                    limits.depth = DEFAULT_SEARCH_DEPTH;
+                    move = threads.think(chessboard, limits);
+                }
+                if (input == "hint") {
+                    std::cout << "Hint: " << chessboard.moveToSAN(move) << std::endl;
+                    continue;
+                }
+            } else {
+                move = chessboard.findMove(input, whiteTurn);
+            }
+
+            if (move != MOVE_NONE) {
+                // THE LOG KEEPS THE FULLY DECORATED SAN, WHATEVER SUFFIX WAS TYPED
+                std::string san = chessboard.moveToSAN(move, whiteTurn ? chessboard.getWhiteLegalMoves() : chessboard.getBlackLegalMoves());
+                chessboard.logMove(san);
+
+                // Check if the move ends with '#'
+                if (san.back() == '#') {
+                    checkmate = true;
+                    std::cout << "Checkmate! Game over." << std::endl;
+                }
+
+                chessboard.playMove(move);
+
+                if (!checkmate && chessboard.isDraw()) {
+                    draw = true;
+                    std::cout << "Draw by repetition or the fifty-move rule." << std::endl;
+                }
+
+                std::cout << "Piece moved: " << squareToString(move.from()) << std::endl;
+
+                // A PONDER SEARCH ON ANOTHER POSITION IS OF NO USE ANY MORE; ITS TRANSPOSITION TABLE ENTRIES STAY
+                if (pondering && chessboard.getKey() != ponderKey) {
+                    threads.stop();
+                    threads.wait();
+                    pondering = false;
+                    std::cout << "Ponder miss" << std::endl;
+                }
+
+                // AFTER ITS OWN MOVE THE COMPUTER STARTS THINKING ABOUT THE REPLY IT EXPECTS
+                Move expected = threads.getPonderMove();
+                if (input == "go" && ponderEnabled && !checkmate && !draw && chessboard.isLegal(expected)) {
+                    Chessboard ponderBoard(chessboard);
+                    ponderBoard.playMove(expected);
+                    // THE LIMITS OF THE MOVE IT WILL PLAY; UNTIL THE PONDER HIT THE SEARCH GOES AS DEEP AS IT CAN
+                    SearchLimits limits;
+                    limits.depth = DEFAULT_SEARCH_DEPTH;
+                    threads.start(ponderBoard, limits, true, false);
+                    pondering = true;
+                    ponderKey = ponderBoard.getKey();
+                    std::cout << "Pondering on " << chessboard.moveToSAN(expected) << std::endl;
+                }
+
+                valid = true;
+            } else {
+                std::cout << "Invalid move. Try again." << std::endl;
+            }
+        }
+
+        ++i;
+
+        whiteTurn = !whiteTurn;
+    }
+    return 0;
 }
\ No newline at end of file